@@ -0,0 +1,367 @@
+/* -----------------------------------------------------------------------
+   bench.c - Copyright (c) 2026  libffi contributors
+
+   Common timing harness for the libffi benchmarks.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include "bench.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+struct bench_options bench_opts = { 0, 20.0, 5, NULL, 0, 0 };
+volatile unsigned long bench_sink;
+
+static char baseline_group[128];
+static double baseline_ns;
+static int header_done;
+
+double
+bench_now_ns (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void
+usage (const char *prog, const struct bench_extra_options *extra)
+{
+  fprintf (stderr,
+	   "usage: %s [OPTION]...\n"
+	   "  -f FORMAT  output format, csv or json (default csv)\n"
+	   "  -t MS      minimum length of one timed sample (default %g)\n"
+	   "  -r N       timed samples per benchmark (default %d)\n"
+	   "  -F FILTER  only run groups whose name contains FILTER\n"
+	   "  -l         list benchmarks instead of running them\n"
+	   "  -c         also report hardware counters per operation\n%s",
+	   prog, bench_opts.min_time_ms, bench_opts.reps,
+	   extra && extra->usage ? extra->usage : "");
+}
+
+int
+bench_init (int argc, char **argv, const struct bench_extra_options *extra)
+{
+  char optstring[64] = "f:t:r:F:lch";
+  int c;
+
+  if (extra && extra->opts)
+    strncat (optstring, extra->opts,
+	     sizeof (optstring) - strlen (optstring) - 1);
+
+  while ((c = getopt (argc, argv, optstring)) != -1)
+    switch (c)
+      {
+      case 'f':
+	if (strcmp (optarg, "json") == 0)
+	  bench_opts.json = 1;
+	else if (strcmp (optarg, "csv") == 0)
+	  bench_opts.json = 0;
+	else
+	  {
+	    usage (argv[0], extra);
+	    return 1;
+	  }
+	break;
+      case 't':
+	bench_opts.min_time_ms = atof (optarg);
+	break;
+      case 'r':
+	bench_opts.reps = atoi (optarg);
+	if (bench_opts.reps < 1)
+	  bench_opts.reps = 1;
+	if (bench_opts.reps > BENCH_MAX_REPS)
+	  bench_opts.reps = BENCH_MAX_REPS;
+	break;
+      case 'F':
+	bench_opts.filter = optarg;
+	break;
+      case 'l':
+	bench_opts.list = 1;
+	break;
+      case 'c':
+	bench_opts.counters = 1;
+	break;
+      case '?':
+      case 'h':
+	usage (argv[0], extra);
+	return 1;
+      default:
+	if (extra == NULL || extra->fn (c, optarg))
+	  {
+	    usage (argv[0], extra);
+	    return 1;
+	  }
+      }
+
+  if (bench_opts.counters && !bench_opts.list)
+    bench_opts.counters = bench_counters_init () > 0;
+
+  return 0;
+}
+
+int
+bench_selected (const char *group)
+{
+  return bench_opts.filter == NULL || strstr (group, bench_opts.filter);
+}
+
+static void
+print_row (const char *group, const char *variant, const char *metric,
+	   double value, double min, unsigned long iters, double ratio)
+{
+  if (bench_opts.json)
+    {
+      printf ("{\"group\":\"%s\",\"variant\":\"%s\",\"metric\":\"%s\","
+	      "\"value\":%.3f", group, variant, metric, value);
+      if (iters)
+	printf (",\"min\":%.3f,\"iters\":%lu", min, iters);
+      if (ratio > 0)
+	printf (",\"ratio\":%.3f", ratio);
+      printf ("}\n");
+    }
+  else
+    {
+      if (!header_done)
+	printf ("group,variant,metric,value,min,iters,ratio\n");
+      header_done = 1;
+      printf ("%s,%s,%s,%.3f,", group, variant, metric, value);
+      if (iters)
+	printf ("%.3f,%lu,", min, iters);
+      else
+	printf (",,");
+      if (ratio > 0)
+	printf ("%.3f", ratio);
+      printf ("\n");
+    }
+  fflush (stdout);
+}
+
+void
+bench_report (const char *group, const char *variant, const char *metric,
+	      double value)
+{
+  print_row (group, variant, metric, value, 0, 0, 0);
+}
+
+static int
+cmp_double (const void *a, const void *b)
+{
+  double x = *(const double *) a, y = *(const double *) b;
+
+  return x < y ? -1 : x > y;
+}
+
+void
+bench_loop_begin (struct bench_loop *l)
+{
+  l->i = 0;
+  l->n = bench_opts.list ? 0 : 1;
+  l->rep = -1;
+  l->counting = 0;
+  l->start = bench_now_ns ();
+}
+
+/* Called when a batch of N iterations is complete.  Decide on the size
+   of the next batch, or return 0 when the measurement is done.  */
+int
+bench_loop_batch (struct bench_loop *l)
+{
+  double t = bench_now_ns () - l->start;
+  double min_ns = bench_opts.min_time_ms * 1e6;
+
+  if (bench_opts.list)
+    return 0;
+
+  if (l->counting)
+    {
+      bench_counters_stop (l->counters);
+      return 0;
+    }
+
+  if (l->rep < 0)
+    {
+      /* Grow the batch until it takes at least min_time_ms.  This also
+	 warms up caches and branch predictors.  */
+      if (t >= min_ns)
+	l->rep = 0;
+      else if (t <= 0)
+	l->n *= 100;
+      else
+	{
+	  double scale = 1.2 * min_ns / t;
+	  l->n *= scale < 2 ? 2 : scale > 100 ? 100 : scale;
+	}
+    }
+  else
+    {
+      l->samples[l->rep++] = t / l->n;
+      if (l->rep == bench_opts.reps)
+	{
+	  if (!bench_opts.counters)
+	    return 0;
+	  /* One more batch, so that reading the counters does not
+	     disturb the timings.  */
+	  l->counting = 1;
+	  bench_counters_start ();
+	}
+    }
+
+  /* The iteration that called us is the first of the new batch.  */
+  l->i = 1;
+  l->start = bench_now_ns ();
+  return 1;
+}
+
+void
+bench_loop_end (struct bench_loop *l, const char *group, const char *variant)
+{
+  double t, ratio = 1;
+  char metric[64];
+  int i;
+
+  if (bench_opts.list)
+    {
+      printf ("%s/%s\n", group, variant);
+      return;
+    }
+
+  qsort (l->samples, bench_opts.reps, sizeof (double), cmp_double);
+  t = l->samples[bench_opts.reps / 2];
+
+  if (strcmp (group, baseline_group) != 0)
+    {
+      snprintf (baseline_group, sizeof (baseline_group), "%s", group);
+      baseline_ns = t;
+    }
+  else if (baseline_ns > 0)
+    ratio = t / baseline_ns;
+
+  print_row (group, variant, "ns_per_op", t, l->samples[0], l->n, ratio);
+
+  if (l->counting)
+    for (i = 0; i < BENCH_NCOUNTERS; i++)
+      if (l->counters[i] >= 0)
+	{
+	  snprintf (metric, sizeof (metric), "%s_per_op",
+		    bench_counter_name (i));
+	  bench_report (group, variant, metric, l->counters[i] / l->n);
+	}
+}
+
+void
+bench_run (const char *group, const char *variant, bench_fn fn, void *ctx)
+{
+  struct bench_loop l;
+
+  bench_loop_begin (&l);
+  while (bench_loop_batch (&l))
+    fn (ctx, l.n);
+  bench_loop_end (&l, group, variant);
+}
+
+/* Values below 8ns get one bucket each; above that, each power of two
+   is split into 8 buckets.  */
+
+static int
+hist_bucket (double ns)
+{
+  unsigned long v = ns < 1 ? 0 : (unsigned long) ns;
+  int log = 0;
+
+  if (v < 8)
+    return v;
+  while ((v >> log) >= 16)
+    log++;
+  /* Now 8 <= v >> log < 16.  */
+  return (log + 1) * 8 + (int) ((v >> log) - 8);
+}
+
+static double
+hist_value (int bucket)
+{
+  int log = bucket / 8 - 1;
+
+  if (bucket < 8)
+    return bucket;
+  /* The midpoint of the bucket.  */
+  return ((bucket % 8) + 8 + 0.5) * (double) (1UL << log);
+}
+
+void
+bench_hist_add (struct bench_hist *h, double ns)
+{
+  int b = hist_bucket (ns);
+
+  if (b >= BENCH_HIST_BUCKETS)
+    b = BENCH_HIST_BUCKETS - 1;
+  h->buckets[b]++;
+  h->count++;
+  if (ns > h->max)
+    h->max = ns;
+}
+
+void
+bench_hist_merge (struct bench_hist *into, const struct bench_hist *h)
+{
+  int i;
+
+  for (i = 0; i < BENCH_HIST_BUCKETS; i++)
+    into->buckets[i] += h->buckets[i];
+  into->count += h->count;
+  if (h->max > into->max)
+    into->max = h->max;
+}
+
+double
+bench_hist_quantile (const struct bench_hist *h, double q)
+{
+  unsigned long want = (unsigned long) (q * h->count);
+  unsigned long seen = 0;
+  int i;
+
+  for (i = 0; i < BENCH_HIST_BUCKETS; i++)
+    {
+      seen += h->buckets[i];
+      if (seen > want)
+	{
+	  double v = hist_value (i);
+	  return v < h->max ? v : h->max;
+	}
+    }
+  return h->max;
+}
+
+void
+bench_report_hist (const char *group, const char *variant,
+		   const struct bench_hist *h)
+{
+  bench_report (group, variant, "p50_ns", bench_hist_quantile (h, 0.5));
+  bench_report (group, variant, "p90_ns", bench_hist_quantile (h, 0.9));
+  bench_report (group, variant, "p99_ns", bench_hist_quantile (h, 0.99));
+  bench_report (group, variant, "p999_ns", bench_hist_quantile (h, 0.999));
+  bench_report (group, variant, "max_ns", h->max);
+}
@@ -0,0 +1,152 @@
+/* -----------------------------------------------------------------------
+   bench.h - Copyright (c) 2026  libffi contributors
+
+   Common timing harness for the libffi benchmarks.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#ifndef LIBFFI_BENCH_H
+#define LIBFFI_BENCH_H
+
+#include <stdio.h>
+
+/* A benchmark body.  It must perform the operation being measured
+   ITERS times.  */
+typedef void (*bench_fn) (void *ctx, unsigned long iters);
+
+struct bench_options
+{
+  /* Emit one JSON object per line instead of CSV.  */
+  int json;
+  /* Minimum duration of one timed sample, in milliseconds.  */
+  double min_time_ms;
+  /* Number of timed samples per benchmark.  */
+  int reps;
+  /* Only run groups whose name contains this string.  */
+  const char *filter;
+  /* Print the benchmark names instead of running them.  */
+  int list;
+  /* Also report hardware counters per operation.  */
+  int counters;
+};
+
+extern struct bench_options bench_opts;
+
+/* Benchmarks store results here so that the compiler cannot discard
+   the work being measured.  */
+extern volatile unsigned long bench_sink;
+
+/* Options specific to one benchmark program.  OPTS is appended to the
+   getopt string of the common options, and each of those options is
+   passed to FN, which returns nonzero if its argument is invalid.
+   USAGE is appended to the usage message.  */
+struct bench_extra_options
+{
+  const char *opts;
+  const char *usage;
+  int (*fn) (int opt, const char *arg);
+};
+
+/* Parse the command line options.  EXTRA may be NULL.  Prints usage
+   and returns nonzero if the program should exit.  */
+int bench_init (int argc, char **argv,
+		const struct bench_extra_options *extra);
+
+/* Return nonzero if GROUP is selected by the filter.  */
+int bench_selected (const char *group);
+
+/* Time FN and report the result as GROUP/VARIANT.  The first variant
+   reported for a group is its baseline; later variants of the same
+   group are also reported as a ratio against it.  */
+void bench_run (const char *group, const char *variant, bench_fn fn,
+		void *ctx);
+
+/* The calibrated loop behind bench_run, for code that cannot be put
+   in a bench_fn.  BENCH_LOOP (GROUP, VARIANT, STMT) runs STMT in
+   batches until enough samples have been taken, then reports them
+   like bench_run.  */
+#define BENCH_MAX_REPS 101
+#define BENCH_NCOUNTERS 5
+
+struct bench_loop
+{
+  unsigned long i;	/* Iterations started in this batch.  */
+  unsigned long n;	/* Iterations per batch.  */
+  double start;
+  int rep;		/* Samples taken, or -1 while calibrating.  */
+  int counting;
+  double samples[BENCH_MAX_REPS];
+  double counters[BENCH_NCOUNTERS];
+};
+
+void bench_loop_begin (struct bench_loop *l);
+int bench_loop_batch (struct bench_loop *l);
+void bench_loop_end (struct bench_loop *l, const char *group,
+		     const char *variant);
+
+#define BENCH_LOOP(group, variant, stmt)				\
+  do {									\
+    struct bench_loop bench_loop_;					\
+    bench_loop_begin (&bench_loop_);					\
+    while (bench_loop_.i++ < bench_loop_.n				\
+	   || bench_loop_batch (&bench_loop_))				\
+      { stmt; }								\
+    bench_loop_end (&bench_loop_, (group), (variant));			\
+  } while (0)
+
+/* Report a value that was not produced by bench_run, such as a
+   throughput or a memory figure, in the same output format.  */
+void bench_report (const char *group, const char *variant,
+		   const char *metric, double value);
+
+/* Monotonic time in nanoseconds.  */
+double bench_now_ns (void);
+
+/* A latency histogram with 1/8-octave resolution.  Not thread-safe;
+   use one per thread and merge them.  */
+#define BENCH_HIST_BUCKETS (64 * 8)
+
+struct bench_hist
+{
+  unsigned long count;
+  double max;
+  unsigned long buckets[BENCH_HIST_BUCKETS];
+};
+
+void bench_hist_add (struct bench_hist *h, double ns);
+void bench_hist_merge (struct bench_hist *into, const struct bench_hist *h);
+/* Return the latency at quantile Q, 0 <= Q <= 1.  */
+double bench_hist_quantile (const struct bench_hist *h, double q);
+/* Report p50, p90, p99, p99.9 and the maximum of H.  */
+void bench_report_hist (const char *group, const char *variant,
+			const struct bench_hist *h);
+
+/* Hardware counters, see counters.c.  bench_counters_init returns the
+   number of counters that could be opened.  bench_counters_stop
+   stores the count of each counter in VALUES, or -1 if that counter
+   is unavailable.  */
+int bench_counters_init (void);
+const char *bench_counter_name (int i);
+void bench_counters_start (void);
+void bench_counters_stop (double *values);
+
+#endif
@@ -0,0 +1,448 @@
+/* -----------------------------------------------------------------------
+   closurestress.c - Copyright (c) 2026  libffi contributors
+
+   Multi-threaded stress benchmark for the closure allocator.
+
+   Each thread allocates, prepares and calls closures in a loop.  Most
+   closures are freed immediately; the rest replace a random entry in
+   a per-thread window of long-lived closures, which fragments the
+   heap the way a real program holding callbacks does.  For each
+   thread count the benchmark reports throughput, the latency
+   distribution of allocation and of freeing, the resident set size,
+   and the number of segments the closure allocator has mapped.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include <ffi.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "bench.h"
+
+#define MAX_THREADS 256
+#define MAX_REGIONS 65536
+
+static unsigned thread_counts[32] = { 1, 2, 4, 8 };
+static int nthread_counts = 4;
+static unsigned long nops = 200000;
+static unsigned window = 256;
+static unsigned short_pct = 90;
+
+/* ---- Segment accounting ----------------------------------------------- */
+
+/* The closure allocator reports every region it maps or unmaps through
+   the ffi_mem_callbacks hooks.  When writable and executable views are
+   mapped separately, each segment is reported twice.  */
+
+struct region
+{
+  char *base;
+  size_t size;
+};
+
+static pthread_mutex_t region_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct region regions[MAX_REGIONS];
+static int nregions;
+
+static void
+on_allocate (void *base, size_t size)
+{
+  pthread_mutex_lock (&region_lock);
+  if (nregions < MAX_REGIONS)
+    {
+      regions[nregions].base = base;
+      regions[nregions].size = size;
+      nregions++;
+    }
+  pthread_mutex_unlock (&region_lock);
+}
+
+static void
+on_deallocate (void *base, size_t size)
+{
+  int i;
+
+  (void) size;
+  pthread_mutex_lock (&region_lock);
+  for (i = 0; i < nregions; i++)
+    if (regions[i].base == base)
+      {
+	regions[i] = regions[--nregions];
+	break;
+      }
+  pthread_mutex_unlock (&region_lock);
+}
+
+/* Count the live regions, their size, and how many of them are mapped
+   executable.  The last needs /proc/self/maps; elsewhere it is
+   reported as -1.  */
+static void
+count_regions (int *count, size_t *bytes, int *exec)
+{
+  int i;
+#ifdef __linux__
+  FILE *maps;
+  char line[512];
+#endif
+
+  pthread_mutex_lock (&region_lock);
+  *count = nregions;
+  *bytes = 0;
+  for (i = 0; i < nregions; i++)
+    *bytes += regions[i].size;
+  *exec = -1;
+
+#ifdef __linux__
+  maps = fopen ("/proc/self/maps", "r");
+  if (maps != NULL)
+    {
+      *exec = 0;
+      while (fgets (line, sizeof (line), maps))
+	{
+	  unsigned long lo, hi;
+	  char perms[5];
+
+	  if (sscanf (line, "%lx-%lx %4s", &lo, &hi, perms) != 3
+	      || perms[2] != 'x')
+	    continue;
+	  for (i = 0; i < nregions; i++)
+	    if ((unsigned long) regions[i].base >= lo
+		&& (unsigned long) regions[i].base < hi)
+	      (*exec)++;
+	}
+      fclose (maps);
+    }
+#endif
+  pthread_mutex_unlock (&region_lock);
+}
+
+static double
+rss_kb (void)
+{
+#ifdef __linux__
+  FILE *f = fopen ("/proc/self/statm", "r");
+  unsigned long size, resident;
+
+  if (f != NULL)
+    {
+      int n = fscanf (f, "%lu %lu", &size, &resident);
+
+      fclose (f);
+      if (n == 2)
+	return resident * (sysconf (_SC_PAGESIZE) / 1024.0);
+    }
+#endif
+  return -1;
+}
+
+static double
+peak_rss_kb (void)
+{
+  struct rusage ru;
+
+  if (getrusage (RUSAGE_SELF, &ru) != 0)
+    return -1;
+#ifdef __APPLE__
+  return ru.ru_maxrss / 1024.0;
+#else
+  return ru.ru_maxrss;
+#endif
+}
+
+/* ---- Threads ---------------------------------------------------------- */
+
+/* pthread_barrier_t is not available everywhere.  */
+struct barrier
+{
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  unsigned count, waiting, generation;
+};
+
+static void
+barrier_init (struct barrier *b, unsigned count)
+{
+  pthread_mutex_init (&b->lock, NULL);
+  pthread_cond_init (&b->cond, NULL);
+  b->count = count;
+  b->waiting = 0;
+  b->generation = 0;
+}
+
+static void
+barrier_wait (struct barrier *b)
+{
+  unsigned gen;
+
+  pthread_mutex_lock (&b->lock);
+  gen = b->generation;
+  if (++b->waiting == b->count)
+    {
+      b->waiting = 0;
+      b->generation++;
+      pthread_cond_broadcast (&b->cond);
+    }
+  else
+    while (gen == b->generation)
+      pthread_cond_wait (&b->cond, &b->lock);
+  pthread_mutex_unlock (&b->lock);
+}
+
+static void
+barrier_destroy (struct barrier *b)
+{
+  pthread_mutex_destroy (&b->lock);
+  pthread_cond_destroy (&b->cond);
+}
+
+struct worker
+{
+  pthread_t thread;
+  unsigned seed;
+  struct bench_hist alloc_hist;
+  struct bench_hist free_hist;
+};
+
+static ffi_cif cif;
+static struct barrier start_barrier, peak_barrier, done_barrier;
+
+static void
+handler (ffi_cif *cif, void *ret, void **args, void *data)
+{
+  (void) cif;
+  (void) data;
+  *(ffi_arg *) ret = *(int *) args[0] + 1;
+}
+
+static unsigned
+xorshift (unsigned *state)
+{
+  unsigned x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
+static void
+timed_free (struct worker *w, ffi_closure *closure)
+{
+  double t = bench_now_ns ();
+
+  ffi_closure_free (closure);
+  bench_hist_add (&w->free_hist, bench_now_ns () - t);
+}
+
+static void *
+worker_main (void *arg)
+{
+  struct worker *w = arg;
+  ffi_closure **live = calloc (window, sizeof (ffi_closure *));
+  unsigned long i;
+  unsigned j;
+
+  if (live == NULL)
+    abort ();
+
+  barrier_wait (&start_barrier);
+
+  for (i = 0; i < nops; i++)
+    {
+      unsigned r = xorshift (&w->seed);
+      ffi_closure *closure;
+      void *code;
+      double t;
+
+      t = bench_now_ns ();
+      closure = ffi_closure_alloc (sizeof (ffi_closure), &code);
+      if (closure == NULL
+	  || ffi_prep_closure_loc (closure, &cif, handler, NULL, code)
+	     != FFI_OK)
+	abort ();
+      bench_hist_add (&w->alloc_hist, bench_now_ns () - t);
+
+      if (((int (*)(int)) code) ((int) i) != (int) i + 1)
+	abort ();
+
+      if (r % 100 < short_pct)
+	timed_free (w, closure);
+      else
+	{
+	  j = (r / 100) % window;
+	  if (live[j])
+	    timed_free (w, live[j]);
+	  live[j] = closure;
+	}
+    }
+
+  /* Let the main thread look at the heap while the long-lived
+     closures are still allocated.  */
+  barrier_wait (&peak_barrier);
+  barrier_wait (&done_barrier);
+
+  for (j = 0; j < window; j++)
+    if (live[j])
+      ffi_closure_free (live[j]);
+  free (live);
+  return NULL;
+}
+
+static void
+run (unsigned nthreads)
+{
+  struct worker *workers = calloc (nthreads, sizeof (struct worker));
+  struct bench_hist *alloc_all = calloc (1, sizeof (struct bench_hist));
+  struct bench_hist *free_all = calloc (1, sizeof (struct bench_hist));
+  char group[64];
+  double t;
+  unsigned i;
+  int segments, exec;
+  size_t bytes;
+
+  if (workers == NULL || alloc_all == NULL || free_all == NULL)
+    abort ();
+
+  snprintf (group, sizeof (group), "closure_mt_%u", nthreads);
+  if (!bench_selected (group))
+    goto out;
+  if (bench_opts.list)
+    {
+      printf ("%s\n", group);
+      goto out;
+    }
+
+  barrier_init (&start_barrier, nthreads + 1);
+  barrier_init (&peak_barrier, nthreads + 1);
+  barrier_init (&done_barrier, nthreads + 1);
+
+  for (i = 0; i < nthreads; i++)
+    {
+      workers[i].seed = 2463534242u + i * 7919;
+      if (pthread_create (&workers[i].thread, NULL, worker_main,
+			  &workers[i]) != 0)
+	abort ();
+    }
+
+  barrier_wait (&start_barrier);
+  t = bench_now_ns ();
+  barrier_wait (&peak_barrier);
+  t = bench_now_ns () - t;
+
+  count_regions (&segments, &bytes, &exec);
+  bench_report (group, "all", "ops_per_sec", nthreads * nops / (t / 1e9));
+  bench_report (group, "all", "rss_kb", rss_kb ());
+  bench_report (group, "all", "peak_rss_kb", peak_rss_kb ());
+  bench_report (group, "all", "mapped_regions", segments);
+  bench_report (group, "all", "mapped_kb", bytes / 1024.0);
+  bench_report (group, "all", "exec_regions", exec);
+
+  barrier_wait (&done_barrier);
+  for (i = 0; i < nthreads; i++)
+    {
+      pthread_join (workers[i].thread, NULL);
+      bench_hist_merge (alloc_all, &workers[i].alloc_hist);
+      bench_hist_merge (free_all, &workers[i].free_hist);
+    }
+  bench_report_hist (group, "alloc_prep", alloc_all);
+  bench_report_hist (group, "free", free_all);
+
+  barrier_destroy (&start_barrier);
+  barrier_destroy (&peak_barrier);
+  barrier_destroy (&done_barrier);
+
+ out:
+  free (workers);
+  free (alloc_all);
+  free (free_all);
+}
+
+static int
+parse_option (int opt, const char *arg)
+{
+  char *end;
+  unsigned long v;
+
+  switch (opt)
+    {
+    case 'T':
+      nthread_counts = 0;
+      do
+	{
+	  v = strtoul (arg, &end, 10);
+	  if (end == arg || v == 0 || v > MAX_THREADS
+	      || nthread_counts == (int) (sizeof (thread_counts)
+					  / sizeof (thread_counts[0])))
+	    return 1;
+	  thread_counts[nthread_counts++] = v;
+	  arg = end + (*end == ',');
+	}
+      while (*end);
+      return 0;
+    case 'n':
+      nops = strtoul (arg, NULL, 10);
+      return nops == 0;
+    case 'w':
+      window = strtoul (arg, NULL, 10);
+      return window == 0;
+    case 's':
+      short_pct = strtoul (arg, NULL, 10);
+      return short_pct > 100;
+    }
+  return 1;
+}
+
+static const struct bench_extra_options extra_options = {
+  "T:n:w:s:",
+  "  -T N[,N]   thread counts to run (default 1,2,4,8)\n"
+  "  -n N       closures allocated per thread (default 200000)\n"
+  "  -w N       long-lived closures kept per thread (default 256)\n"
+  "  -s PCT     percentage of closures freed at once (default 90)\n",
+  parse_option
+};
+
+int
+main (int argc, char **argv)
+{
+  static ffi_type *args[] = { &ffi_type_sint };
+  ffi_mem_callbacks callbacks = { malloc, calloc, free,
+				  on_allocate, on_deallocate };
+  int i;
+
+  if (bench_init (argc, argv, &extra_options))
+    return 2;
+
+  ffi_set_mem_callbacks (&callbacks);
+
+  if (ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 1, &ffi_type_sint, args)
+      != FFI_OK)
+    abort ();
+
+  for (i = 0; i < nthread_counts; i++)
+    run (thread_counts[i]);
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+/* -----------------------------------------------------------------------
+   counters.c - Copyright (c) 2026  libffi contributors
+
+   Hardware performance counters for the benchmark harness.
+
+   On Linux the counters are read with perf_event_open.  Each event is
+   opened on its own, so that an event the PMU does not support (as is
+   common in virtual machines) does not take the others with it; the
+   counts are scaled if the kernel had to multiplex them.  Elsewhere no
+   counters are available and the harness reports only times.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include "bench.h"
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <stdint.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define CACHE_READ_MISS(cache)						\
+  ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8)				\
+   | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const struct
+{
+  const char *name;
+  uint32_t type;
+  uint64_t config;
+} events[BENCH_NCOUNTERS] = {
+  { "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { "branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  { "l1i_misses", PERF_TYPE_HW_CACHE,
+    CACHE_READ_MISS (PERF_COUNT_HW_CACHE_L1I) },
+  { "itlb_misses", PERF_TYPE_HW_CACHE,
+    CACHE_READ_MISS (PERF_COUNT_HW_CACHE_ITLB) },
+};
+
+static int fds[BENCH_NCOUNTERS] = { -1, -1, -1, -1, -1 };
+
+const char *
+bench_counter_name (int i)
+{
+  return events[i].name;
+}
+
+int
+bench_counters_init (void)
+{
+  struct perf_event_attr attr;
+  int i, n = 0, err = 0;
+
+  for (i = 0; i < BENCH_NCOUNTERS; i++)
+    {
+      memset (&attr, 0, sizeof (attr));
+      attr.size = sizeof (attr);
+      attr.type = events[i].type;
+      attr.config = events[i].config;
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = (PERF_FORMAT_TOTAL_TIME_ENABLED
+			  | PERF_FORMAT_TOTAL_TIME_RUNNING);
+
+      fds[i] = syscall (SYS_perf_event_open, &attr, 0, -1, -1, 0);
+      if (fds[i] >= 0)
+	n++;
+      else
+	err = errno;
+    }
+
+  if (n == 0)
+    fprintf (stderr, "warning: no hardware counters available (%s)%s\n",
+	     strerror (err),
+	     err == EACCES || err == EPERM
+	     ? "; see /proc/sys/kernel/perf_event_paranoid" : "");
+  return n;
+}
+
+void
+bench_counters_start (void)
+{
+  int i;
+
+  for (i = 0; i < BENCH_NCOUNTERS; i++)
+    if (fds[i] >= 0)
+      {
+	ioctl (fds[i], PERF_EVENT_IOC_RESET, 0);
+	ioctl (fds[i], PERF_EVENT_IOC_ENABLE, 0);
+      }
+}
+
+void
+bench_counters_stop (double *values)
+{
+  uint64_t buf[3];
+  int i;
+
+  for (i = 0; i < BENCH_NCOUNTERS; i++)
+    if (fds[i] >= 0)
+      ioctl (fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+  for (i = 0; i < BENCH_NCOUNTERS; i++)
+    {
+      values[i] = -1;
+      if (fds[i] < 0
+	  || read (fds[i], buf, sizeof (buf)) != sizeof (buf)
+	  || buf[2] == 0)
+	continue;
+      /* buf[1] and buf[2] are the times the event was enabled and
+	 actually counting.  */
+      values[i] = (double) buf[0] * buf[1] / buf[2];
+    }
+}
+
+#else /* !__linux__ */
+
+const char *
+bench_counter_name (int i)
+{
+  (void) i;
+  return "";
+}
+
+int
+bench_counters_init (void)
+{
+  fprintf (stderr, "warning: hardware counters are only supported on "
+	   "Linux\n");
+  return 0;
+}
+
+void
+bench_counters_start (void)
+{
+}
+
+void
+bench_counters_stop (double *values)
+{
+  int i;
+
+  for (i = 0; i < BENCH_NCOUNTERS; i++)
+    values[i] = -1;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,555 @@
+/* -----------------------------------------------------------------------
+   ffibench.c - Copyright (c) 2026  libffi contributors
+
+   Microbenchmarks for ffi_call, closures and cif preparation.
+
+   Every signature is called directly from C, through ffi_call, both
+   before and after ffi_call promotes it to a plan of its own, and
+   ffi_call_packed, through a call plan, through a plan with all but
+   its last argument bound, through a prefilled call image where the
+   target has them and, where the raw API exists, through
+   ffi_raw_call.  A closure with the same signature, and packed and
+   typed closures where the target supports them, are also called
+   from C.  The direct call is the baseline of each group, so the
+   "ratio" column is the cost of going through libffi relative to a
+   plain indirect call.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include <ffi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+#define MAX_ARGS 16
+
+#define NOINLINE __attribute__((noinline))
+
+#define ffi_type_int	ffi_type_sint
+
+/* Parameter lists, call argument lists and sums for N arguments.  */
+#define P0(T)	void
+#define P1(T)	T a0
+#define P2(T)	P1(T), T a1
+#define P3(T)	P2(T), T a2
+#define P4(T)	P3(T), T a3
+#define P6(T)	P4(T), T a4, T a5
+#define P8(T)	P6(T), T a6, T a7
+#define P12(T)	P8(T), T a8, T a9, T a10, T a11
+#define P16(T)	P12(T), T a12, T a13, T a14, T a15
+
+#define C0(v)
+#define C1(v)	v[0]
+#define C2(v)	C1(v), v[1]
+#define C3(v)	C2(v), v[2]
+#define C4(v)	C3(v), v[3]
+#define C6(v)	C4(v), v[4], v[5]
+#define C8(v)	C6(v), v[6], v[7]
+#define C12(v)	C8(v), v[8], v[9], v[10], v[11]
+#define C16(v)	C12(v), v[12], v[13], v[14], v[15]
+
+#define S0	0
+#define S1	a0
+#define S2	S1 + a1
+#define S3	S2 + a2
+#define S4	S3 + a3
+#define S6	S4 + a4 + a5
+#define S8	S6 + a6 + a7
+#define S12	S8 + a8 + a9 + a10 + a11
+#define S16	S12 + a12 + a13 + a14 + a15
+
+struct small { int a, b; };			/* One GPR.  */
+struct medium { double x, y; };			/* Two SSE registers.  */
+struct large { long a, b, c, d; };		/* Passed in memory.  */
+
+static int int_vals[MAX_ARGS];
+static float float_vals[MAX_ARGS];
+static double double_vals[MAX_ARGS];
+static struct small small_val = { 1, 2 };
+static struct medium medium_val = { 1.5, 2.5 };
+static struct large large_val = { 1, 2, 3, 4 };
+static int one = 1;
+
+struct sig
+{
+  const char *group;
+  ffi_cif cif;
+  ffi_type *atypes[MAX_ARGS];
+  void *avalues[MAX_ARGS];
+  void (*fn)(void);
+  /* The function called by the typed DIRECT loop: either FN or the
+     code address of CLOSURE.  */
+  void (*target)(void);
+  bench_fn direct;
+  ffi_plan *plan;
+  void *image;
+  ffi_closure *closure;
+  void *code;
+#if !FFI_NO_RAW_API
+  ffi_raw *raw;
+#endif
+};
+
+/* Define the C implementation of an N-ary signature over type T and
+   the loop that calls it with a typed, indirect call.  */
+#define NARY(T, N)							\
+  static NOINLINE T sum_##T##_##N (P##N(T)) { return S##N; }		\
+  static void direct_##T##_##N (void *ctx, unsigned long iters)		\
+  {									\
+    T (*fn) (P##N(T)) = (T (*) (P##N(T))) ((struct sig *) ctx)->target; \
+    T *v = T##_vals;							\
+    double acc = 0;							\
+    (void) v;								\
+    while (iters--)							\
+      acc += fn (C##N(v));						\
+    bench_sink = (unsigned long) acc;					\
+  }
+
+#define NARY_ALL(N)	NARY(int, N) NARY(float, N) NARY(double, N)
+
+NARY_ALL(0) NARY_ALL(1) NARY_ALL(2) NARY_ALL(3) NARY_ALL(4)
+NARY_ALL(6) NARY_ALL(8) NARY_ALL(12) NARY_ALL(16)
+
+/* Struct arguments and returns.  */
+#define STRUCT_ARG(S, SUM)						\
+  static NOINLINE long S##_arg (struct S s) { return SUM; }		\
+  static void direct_##S##_arg (void *ctx, unsigned long iters)		\
+  {									\
+    long (*fn) (struct S) = (long (*) (struct S)) ((struct sig *) ctx)->target; \
+    long acc = 0;							\
+    while (iters--)							\
+      acc += fn (S##_val);						\
+    bench_sink = acc;							\
+  }
+
+#define STRUCT_RET(S, F)						\
+  static NOINLINE struct S S##_ret (int i)				\
+  {									\
+    struct S r = S##_val;						\
+    r.F = i;								\
+    return r;								\
+  }									\
+  static void direct_##S##_ret (void *ctx, unsigned long iters)		\
+  {									\
+    struct S (*fn) (int) = (struct S (*) (int)) ((struct sig *) ctx)->target; \
+    double acc = 0;							\
+    while (iters--)							\
+      acc += fn (1).F;							\
+    bench_sink = (unsigned long) acc;					\
+  }
+
+STRUCT_ARG(small, s.a + s.b)
+STRUCT_ARG(medium, (long) (s.x + s.y))
+STRUCT_ARG(large, s.a + s.b + s.c + s.d)
+STRUCT_RET(small, a)
+STRUCT_RET(medium, x)
+STRUCT_RET(large, a)
+
+static ffi_type *small_elements[] = { &ffi_type_sint, &ffi_type_sint, NULL };
+static ffi_type *medium_elements[] =
+  { &ffi_type_double, &ffi_type_double, NULL };
+static ffi_type *large_elements[] = { &ffi_type_slong, &ffi_type_slong,
+				      &ffi_type_slong, &ffi_type_slong, NULL };
+static ffi_type small_type = { 0, 0, FFI_TYPE_STRUCT, small_elements };
+static ffi_type medium_type = { 0, 0, FFI_TYPE_STRUCT, medium_elements };
+static ffi_type large_type = { 0, 0, FFI_TYPE_STRUCT, large_elements };
+
+static void
+closure_handler (ffi_cif *cif, void *ret, void **args, void *data)
+{
+  size_t size = cif->rtype->size;
+
+  (void) args;
+  (void) data;
+  memset (ret, 0, size < sizeof (ffi_arg) ? sizeof (ffi_arg) : size);
+}
+
+static void
+packed_handler (ffi_cif *cif, void *ret, void *args, void *data)
+{
+  size_t size = cif->rtype->size;
+
+  (void) args;
+  (void) data;
+  memset (ret, 0, size < sizeof (ffi_arg) ? sizeof (ffi_arg) : size);
+}
+
+/* The target of the typed closures.  It ignores its arguments, and its
+   result comes back in both %rax and %xmm0 on x86-64, so that it can
+   stand in for every scalar return type.  */
+struct typed_result
+{
+  long l;
+  double d;
+};
+
+static struct typed_result
+typed_handler (void *data)
+{
+  struct typed_result r = { 0, 0 };
+
+  (void) data;
+  return r;
+}
+
+static void
+ffi_call_loop (void *ctx, unsigned long iters)
+{
+  struct sig *s = ctx;
+  union { ffi_arg a; double d; char buf[64]; } rv;
+
+  while (iters--)
+    ffi_call (&s->cif, s->fn, &rv, s->avalues);
+  bench_sink = rv.a;
+}
+
+static void
+ffi_call_plan_loop (void *ctx, unsigned long iters)
+{
+  struct sig *s = ctx;
+  union { ffi_arg a; double d; char buf[64]; } rv;
+
+  while (iters--)
+    ffi_call_plan (s->plan, s->fn, &rv, s->avalues);
+  bench_sink = rv.a;
+}
+
+static void
+ffi_call_image_loop (void *ctx, unsigned long iters)
+{
+  struct sig *s = ctx;
+  union { ffi_arg a; double d; char buf[64]; } rv;
+
+  while (iters--)
+    ffi_call_image (&s->cif, s->fn, &rv, s->image);
+  bench_sink = rv.a;
+}
+
+static void
+ffi_call_packed_loop (void *ctx, unsigned long iters)
+{
+  struct sig *s = ctx;
+  union { ffi_arg a; double d; char buf[64]; } rv;
+
+  /* The arguments of every signature are consecutive elements of one
+     array, which is also their packed block.  */
+  while (iters--)
+    ffi_call_packed (&s->cif, s->fn, &rv, s->avalues[0]);
+  bench_sink = rv.a;
+}
+
+#if !FFI_NO_RAW_API
+static void
+ffi_raw_call_loop (void *ctx, unsigned long iters)
+{
+  struct sig *s = ctx;
+  union { ffi_arg a; double d; char buf[64]; } rv;
+
+  while (iters--)
+    ffi_raw_call (&s->cif, s->fn, &rv, s->raw);
+  bench_sink = rv.a;
+}
+#endif
+
+static void
+prep_cif_loop (void *ctx, unsigned long iters)
+{
+  struct sig *s = ctx;
+  ffi_cif cif;
+
+  while (iters--)
+    ffi_prep_cif (&cif, FFI_DEFAULT_ABI, s->cif.nargs, s->cif.rtype,
+		  s->atypes);
+  bench_sink = cif.bytes;
+}
+
+static void
+run_sig (struct sig *s, int raw)
+{
+  ffi_image_layout layout;
+  size_t offsets[MAX_ARGS];
+  unsigned i;
+
+  if (!bench_selected (s->group))
+    return;
+
+  s->target = s->fn;
+  bench_run (s->group, "direct", s->direct, s);
+  bench_run (s->group, "ffi_call", ffi_call_loop, s);
+
+  /* Promoted by its first call.  Cifs that are not lowered into plans
+     are not promoted, and take the same path as above.  */
+  ffi_set_tier_threshold (1);
+  bench_run (s->group, "ffi_call_promoted", ffi_call_loop, s);
+  ffi_set_tier_threshold (0);
+  ffi_cif_release (&s->cif);
+
+  if (s->cif.nargs > 0)
+    bench_run (s->group, "ffi_call_packed", ffi_call_packed_loop, s);
+
+  s->plan = ffi_plan_alloc (&s->cif);
+  if (s->plan == NULL)
+    abort ();
+  bench_run (s->group, "ffi_call_plan", ffi_call_plan_loop, s);
+  ffi_plan_free (s->plan);
+
+  if (s->cif.nargs > 1)
+    {
+      /* Bind every argument but the last.  */
+      void *bound[MAX_ARGS] = { NULL };
+
+      memcpy (bound, s->avalues, (s->cif.nargs - 1) * sizeof (void *));
+      s->plan = ffi_plan_alloc_bound (&s->cif, bound);
+      if (s->plan == NULL)
+	abort ();
+      bench_run (s->group, "ffi_call_plan_bound", ffi_call_plan_loop, s);
+      ffi_plan_free (s->plan);
+    }
+
+  if (ffi_get_image_layout (&s->cif, &layout, offsets) == FFI_OK)
+    {
+      /* The arguments are never negative, so zero-extending the
+	 integers is enough.  */
+      s->image = calloc (1, layout.size);
+      if (s->image == NULL)
+	abort ();
+      for (i = 0; i < s->cif.nargs; i++)
+	memcpy ((char *) s->image + offsets[i], s->avalues[i],
+		s->atypes[i]->size);
+      bench_run (s->group, "ffi_call_image", ffi_call_image_loop, s);
+      free (s->image);
+    }
+
+#if !FFI_NO_RAW_API
+  if (raw)
+    {
+      s->raw = malloc (ffi_raw_size (&s->cif) + sizeof (ffi_raw));
+      ffi_ptrarray_to_raw (&s->cif, s->avalues, s->raw);
+      bench_run (s->group, "ffi_raw_call", ffi_raw_call_loop, s);
+      free (s->raw);
+    }
+#else
+  (void) raw;
+#endif
+
+  s->closure = ffi_closure_alloc (sizeof (ffi_closure), &s->code);
+  if (s->closure == NULL
+      || ffi_prep_closure_loc (s->closure, &s->cif, closure_handler, NULL,
+			       s->code) != FFI_OK)
+    abort ();
+  s->target = (void (*)(void)) s->code;
+  bench_run (s->group, "closure", s->direct, s);
+
+  if (ffi_prep_packed_closure_loc (s->closure, &s->cif, packed_handler, NULL,
+				   s->code) == FFI_OK)
+    bench_run (s->group, "packed_closure", s->direct, s);
+
+  if (ffi_prep_typed_closure_loc (s->closure, &s->cif,
+				  (void (*)(void)) typed_handler, NULL,
+				  s->code) == FFI_OK)
+    bench_run (s->group, "typed_closure", s->direct, s);
+  ffi_closure_free (s->closure);
+}
+
+static void
+setup_sig (struct sig *s, const char *group, ffi_type *rtype,
+	   unsigned nargs, ffi_type *atype, void *vals, size_t stride,
+	   void (*fn)(void), bench_fn direct)
+{
+  unsigned i;
+
+  s->group = group;
+  s->fn = fn;
+  s->direct = direct;
+  for (i = 0; i < nargs; i++)
+    {
+      s->atypes[i] = atype;
+      s->avalues[i] = (char *) vals + i * stride;
+    }
+  if (ffi_prep_cif (&s->cif, FFI_DEFAULT_ABI, nargs, rtype, s->atypes)
+      != FFI_OK)
+    abort ();
+}
+
+#define RUN_NARY(T, N)							\
+  do {									\
+    struct sig s;							\
+    setup_sig (&s, #T "_" #N, &ffi_type_##T, N, &ffi_type_##T,		\
+	       T##_vals, sizeof (T), (void (*)(void)) sum_##T##_##N,	\
+	       direct_##T##_##N);					\
+    run_sig (&s, 1);							\
+  } while (0)
+
+#define RUN_NARY_ALL(N)							\
+  do {									\
+    RUN_NARY(int, N); RUN_NARY(float, N); RUN_NARY(double, N);		\
+  } while (0)
+
+static void
+bench_prep (void)
+{
+  struct sig s;
+
+  if (!bench_selected ("prep_cif"))
+    return;
+
+  setup_sig (&s, "prep_cif", &ffi_type_void, 0, NULL, NULL, 0, NULL, NULL);
+  bench_run ("prep_cif", "void_0", prep_cif_loop, &s);
+  setup_sig (&s, "prep_cif", &ffi_type_double, 16, &ffi_type_double,
+	     double_vals, sizeof (double), NULL, NULL);
+  bench_run ("prep_cif", "double_16", prep_cif_loop, &s);
+  /* Struct types are laid out by the first ffi_prep_cif; after that
+     only classification is repeated.  */
+  setup_sig (&s, "prep_cif", &large_type, 4, &medium_type,
+	     &medium_val, 0, NULL, NULL);
+  bench_run ("prep_cif", "struct_4", prep_cif_loop, &s);
+}
+
+static void
+prep_cif_var_loop (void *ctx, unsigned long iters)
+{
+  struct sig *s = ctx;
+  ffi_cif cif;
+
+  while (iters--)
+    ffi_prep_cif_var (&cif, FFI_DEFAULT_ABI, 1, s->cif.nargs,
+		      s->cif.rtype, s->atypes);
+  bench_sink = cif.bytes;
+}
+
+static void
+bench_prep_var (void)
+{
+  struct sig s;
+  unsigned i;
+
+  if (!bench_selected ("prep_cif_var"))
+    return;
+
+  /* int printf (const char *, ...) with 0, 3 and 8 variadic doubles.  */
+  s.cif.rtype = &ffi_type_sint;
+  s.atypes[0] = &ffi_type_pointer;
+  for (i = 1; i < MAX_ARGS; i++)
+    s.atypes[i] = &ffi_type_double;
+  s.cif.nargs = 1;
+  bench_run ("prep_cif_var", "fixed1_var0", prep_cif_var_loop, &s);
+  s.cif.nargs = 4;
+  bench_run ("prep_cif_var", "fixed1_var3", prep_cif_var_loop, &s);
+  s.cif.nargs = 9;
+  bench_run ("prep_cif_var", "fixed1_var8", prep_cif_var_loop, &s);
+}
+
+static void
+closure_alloc_loop (void *ctx, unsigned long iters)
+{
+  void *code;
+
+  (void) ctx;
+  while (iters--)
+    ffi_closure_free (ffi_closure_alloc (sizeof (ffi_closure), &code));
+}
+
+static void
+closure_prep_loop (void *ctx, unsigned long iters)
+{
+  ffi_cif *cif = ctx;
+  ffi_closure *closure;
+  void *code;
+
+  while (iters--)
+    {
+      closure = ffi_closure_alloc (sizeof (ffi_closure), &code);
+      ffi_prep_closure_loc (closure, cif, closure_handler, NULL, code);
+      ffi_closure_free (closure);
+    }
+}
+
+static void
+bench_closure_alloc (void)
+{
+  ffi_cif cif;
+
+  if (!bench_selected ("closure_alloc"))
+    return;
+
+  if (ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 0, &ffi_type_void, NULL)
+      != FFI_OK)
+    abort ();
+  bench_run ("closure_alloc", "alloc_free", closure_alloc_loop, NULL);
+  bench_run ("closure_alloc", "alloc_prep_free", closure_prep_loop, &cif);
+}
+
+int
+main (int argc, char **argv)
+{
+  struct sig s;
+  int i;
+
+  if (bench_init (argc, argv, NULL))
+    return 2;
+
+  for (i = 0; i < MAX_ARGS; i++)
+    {
+      int_vals[i] = i + 1;
+      float_vals[i] = i + 0.5f;
+      double_vals[i] = i + 0.25;
+    }
+
+  RUN_NARY_ALL(0);
+  RUN_NARY_ALL(1);
+  RUN_NARY_ALL(2);
+  RUN_NARY_ALL(3);
+  RUN_NARY_ALL(4);
+  RUN_NARY_ALL(6);
+  RUN_NARY_ALL(8);
+  RUN_NARY_ALL(12);
+  RUN_NARY_ALL(16);
+
+  setup_sig (&s, "struct_small_arg", &ffi_type_slong, 1, &small_type,
+	     &small_val, 0, (void (*)(void)) small_arg, direct_small_arg);
+  run_sig (&s, 0);
+  setup_sig (&s, "struct_medium_arg", &ffi_type_slong, 1, &medium_type,
+	     &medium_val, 0, (void (*)(void)) medium_arg, direct_medium_arg);
+  run_sig (&s, 0);
+  setup_sig (&s, "struct_large_arg", &ffi_type_slong, 1, &large_type,
+	     &large_val, 0, (void (*)(void)) large_arg, direct_large_arg);
+  run_sig (&s, 0);
+
+  setup_sig (&s, "struct_small_ret", &small_type, 1, &ffi_type_sint,
+	     &one, 0, (void (*)(void)) small_ret, direct_small_ret);
+  run_sig (&s, 0);
+  setup_sig (&s, "struct_medium_ret", &medium_type, 1, &ffi_type_sint,
+	     &one, 0, (void (*)(void)) medium_ret, direct_medium_ret);
+  run_sig (&s, 0);
+  /* Returned in memory; UNIX64_FLAG_RET_IN_MEM on x86-64.  */
+  setup_sig (&s, "struct_large_ret", &large_type, 1, &ffi_type_sint,
+	     &one, 0, (void (*)(void)) large_ret, direct_large_ret);
+  run_sig (&s, 0);
+
+  bench_prep ();
+  bench_prep_var ();
+  bench_closure_alloc ();
+
+  return 0;
+}
@@ -0,0 +1,365 @@
+/* -----------------------------------------------------------------------
+   ffireplay.c - Copyright (c) 2026  libffi contributors
+
+   Replay a trace written by ffi_record_start.
+
+   Each call in the trace is made again through ffi_call, with zeroed
+   arguments, to a function that returns at once; each closure
+   invocation is made through ffi_call to a closure of the same
+   signature whose handler returns at once.  The events are replayed
+   in their recorded order, so that the mix of signatures and the
+   branch patterns are those of the recorded program.  The baseline
+   makes a direct call to an empty function per event, so the ratio
+   against it is roughly the time spent in libffi.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include <ffi.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+#define NOINLINE __attribute__((noinline))
+
+struct sig
+{
+  ffi_cif cif;
+  ffi_type **args;
+  void **values;
+  void *rvalue;
+  ffi_closure *closure;
+  void (*code) (void);
+};
+
+struct event
+{
+  unsigned sig;
+  int closure;
+};
+
+static const char *trace_path;
+
+/* Closures point to the cifs, so each sig is allocated on its own.  */
+static struct sig **sigs;
+static unsigned nsigs;
+static struct event *events;
+static unsigned long nevents;
+
+static const unsigned char *pos, *end;
+
+static void
+fail (const char *msg)
+{
+  fprintf (stderr, "%s: %s\n", trace_path, msg);
+  exit (1);
+}
+
+static unsigned
+read_u8 (void)
+{
+  if (pos + 1 > end)
+    fail ("truncated trace");
+  return *pos++;
+}
+
+static unsigned
+read_u16 (void)
+{
+  uint16_t v;
+
+  if (pos + sizeof (v) > end)
+    fail ("truncated trace");
+  memcpy (&v, pos, sizeof (v));
+  pos += sizeof (v);
+  return v;
+}
+
+static unsigned
+read_u32 (void)
+{
+  uint32_t v;
+
+  if (pos + sizeof (v) > end)
+    fail ("truncated trace");
+  memcpy (&v, pos, sizeof (v));
+  pos += sizeof (v);
+  return v;
+}
+
+static ffi_type *
+read_type (void)
+{
+  unsigned code = read_u8 (), n, i;
+  ffi_type *t;
+
+  switch (code)
+    {
+    case FFI_TYPE_VOID: return &ffi_type_void;
+    case FFI_TYPE_INT: return &ffi_type_sint;
+    case FFI_TYPE_FLOAT: return &ffi_type_float;
+    case FFI_TYPE_DOUBLE: return &ffi_type_double;
+#if FFI_TYPE_LONGDOUBLE != FFI_TYPE_DOUBLE
+    case FFI_TYPE_LONGDOUBLE: return &ffi_type_longdouble;
+#endif
+    case FFI_TYPE_UINT8: return &ffi_type_uint8;
+    case FFI_TYPE_SINT8: return &ffi_type_sint8;
+    case FFI_TYPE_UINT16: return &ffi_type_uint16;
+    case FFI_TYPE_SINT16: return &ffi_type_sint16;
+    case FFI_TYPE_UINT32: return &ffi_type_uint32;
+    case FFI_TYPE_SINT32: return &ffi_type_sint32;
+    case FFI_TYPE_UINT64: return &ffi_type_uint64;
+    case FFI_TYPE_SINT64: return &ffi_type_sint64;
+    case FFI_TYPE_POINTER: return &ffi_type_pointer;
+    case FFI_TYPE_STRUCT:
+      n = read_u16 ();
+      t = calloc (1, sizeof (ffi_type) + (n + 1) * sizeof (ffi_type *));
+      if (t == NULL)
+	abort ();
+      t->type = FFI_TYPE_STRUCT;
+      t->elements = (ffi_type **) (t + 1);
+      for (i = 0; i < n; i++)
+	t->elements[i] = read_type ();
+      return t;
+#ifdef FFI_TARGET_HAS_COMPLEX_TYPE
+    case FFI_TYPE_COMPLEX:
+      switch (read_type ()->type)
+	{
+	case FFI_TYPE_FLOAT: return &ffi_type_complex_float;
+	case FFI_TYPE_DOUBLE: return &ffi_type_complex_double;
+	default: return &ffi_type_complex_longdouble;
+	}
+#endif
+    }
+  fail ("unknown type in trace");
+  return NULL;
+}
+
+static void
+noop_handler (ffi_cif *cif, void *resp, void **args, void *userdata)
+{
+  (void) args;
+  (void) userdata;
+  memset (resp, 0, cif->rtype->size < sizeof (ffi_arg)
+		   ? sizeof (ffi_arg) : cif->rtype->size);
+}
+
+static NOINLINE void
+noop (void)
+{
+}
+
+static void
+define_sig (void)
+{
+  unsigned id = read_u32 (), abi, nargs, i;
+  size_t size;
+  struct sig *s;
+
+  if (id >= nsigs)
+    {
+      unsigned n = id + 16;
+
+      sigs = realloc (sigs, n * sizeof (*sigs));
+      if (sigs == NULL)
+	abort ();
+      memset (sigs + nsigs, 0, (n - nsigs) * sizeof (*sigs));
+      nsigs = n;
+    }
+  if (sigs[id] != NULL)
+    fail ("signature defined twice in trace");
+  s = sigs[id] = calloc (1, sizeof (*s));
+  if (s == NULL)
+    abort ();
+
+  abi = read_u8 ();
+  nargs = read_u16 ();
+  s->args = malloc ((nargs + 1) * sizeof (ffi_type *));
+  s->values = malloc ((nargs + 1) * sizeof (void *));
+  if (s->args == NULL || s->values == NULL)
+    abort ();
+  s->args[nargs] = read_type ();
+  for (i = 0; i < nargs; i++)
+    s->args[i] = read_type ();
+  if (ffi_prep_cif (&s->cif, (ffi_abi) abi, nargs, s->args[nargs], s->args)
+      != FFI_OK)
+    fail ("cannot prepare a recorded signature");
+
+  for (i = 0; i < nargs; i++)
+    if ((s->values[i] = calloc (1, s->args[i]->size)) == NULL)
+      abort ();
+  size = s->cif.rtype->size < sizeof (ffi_arg)
+	 ? sizeof (ffi_arg) : s->cif.rtype->size;
+  if ((s->rvalue = calloc (1, size)) == NULL)
+    abort ();
+
+  s->closure = ffi_closure_alloc (sizeof (ffi_closure), (void **) &s->code);
+  if (s->closure == NULL
+      || ffi_prep_closure_loc (s->closure, &s->cif, noop_handler, NULL,
+			       (void *) s->code) != FFI_OK)
+    fail ("cannot prepare a closure for a recorded signature");
+}
+
+static void
+load_trace (void)
+{
+  unsigned char *data = NULL;
+  unsigned long nalloc = 0;
+  size_t size = 0, n;
+  FILE *f = fopen (trace_path, "rb");
+
+  if (f == NULL)
+    {
+      perror (trace_path);
+      exit (1);
+    }
+  for (;;)
+    {
+      data = realloc (data, size + 65536);
+      if (data == NULL)
+	abort ();
+      n = fread (data + size, 1, 65536, f);
+      size += n;
+      if (n < 65536)
+	break;
+    }
+  fclose (f);
+
+  pos = data;
+  end = data + size;
+  if (size < sizeof (FFI_RECORD_MAGIC)
+      || memcmp (data, FFI_RECORD_MAGIC, sizeof (FFI_RECORD_MAGIC)) != 0)
+    fail ("not a libffi trace");
+  pos += sizeof (FFI_RECORD_MAGIC);
+
+  while (pos < end)
+    {
+      unsigned tag = read_u8 (), id;
+
+      if (tag == 'S')
+	{
+	  define_sig ();
+	  continue;
+	}
+      if (tag != 'C' && tag != 'K')
+	fail ("unknown record in trace");
+      id = read_u32 ();
+      if (id >= nsigs || sigs[id] == NULL)
+	fail ("undefined signature in trace");
+      if (nevents == nalloc)
+	{
+	  nalloc = nalloc ? 2 * nalloc : 1024;
+	  events = realloc (events, nalloc * sizeof (*events));
+	  if (events == NULL)
+	    abort ();
+	}
+      events[nevents].sig = id;
+      events[nevents].closure = tag == 'K';
+      nevents++;
+    }
+  if (nevents == 0)
+    fail ("no calls in trace");
+}
+
+static void
+bench_direct (void *ctx, unsigned long iters)
+{
+  void (*volatile fn) (void) = noop;
+  unsigned long i, e = 0;
+
+  (void) ctx;
+  for (i = 0; i < iters; i++)
+    {
+      fn ();
+      if (++e == nevents)
+	e = 0;
+    }
+}
+
+static void
+bench_replay (void *ctx, unsigned long iters)
+{
+  unsigned long i, e = 0;
+
+  (void) ctx;
+  for (i = 0; i < iters; i++)
+    {
+      struct sig *s = sigs[events[e].sig];
+
+      ffi_call (&s->cif, events[e].closure ? s->code : FFI_FN (noop),
+		s->rvalue, s->values);
+      if (++e == nevents)
+	e = 0;
+    }
+}
+
+static int
+parse_option (int opt, const char *arg)
+{
+  if (opt != 'i')
+    return 1;
+  trace_path = arg;
+  return 0;
+}
+
+static const struct bench_extra_options extra_options = {
+  "i:",
+  "  -i FILE    trace to replay, written by ffi_record_start (required)\n",
+  parse_option
+};
+
+int
+main (int argc, char **argv)
+{
+  unsigned long closures = 0, i;
+  unsigned used = 0;
+
+  if (bench_init (argc, argv, &extra_options))
+    return 2;
+  if (trace_path == NULL)
+    {
+      fprintf (stderr, "%s: no trace given, use -i FILE\n", argv[0]);
+      return 2;
+    }
+
+  load_trace ();
+  for (i = 0; i < nevents; i++)
+    closures += events[i].closure;
+  for (i = 0; i < nsigs; i++)
+    used += sigs[i] != NULL;
+
+  if (bench_selected ("replay"))
+    {
+      if (!bench_opts.list)
+	{
+	  bench_report ("replay", "trace", "events", nevents);
+	  bench_report ("replay", "trace", "closures", closures);
+	  bench_report ("replay", "trace", "signatures", used);
+	}
+      bench_run ("replay", "direct", bench_direct, NULL);
+      bench_run ("replay", "libffi", bench_replay, NULL);
+    }
+
+  return 0;
+}
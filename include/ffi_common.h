@@ -74,6 +74,40 @@ void ffi_type_test(ffi_type *a, char *file, int line);
 #define FFI_ASSERT_VALID_TYPE(x)
 #endif
 
+/* Static tracepoints of the "libffi" provider, for SystemTap, perf and
+   bpftrace.  Each is a single nop until a tracer attaches to it.  */
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+#define FFI_PROBE2(name, a, b) STAP_PROBE2 (libffi, name, a, b)
+#define FFI_PROBE3(name, a, b, c) STAP_PROBE3 (libffi, name, a, b, c)
+#else
+#define FFI_PROBE2(name, a, b)
+#define FFI_PROBE3(name, a, b, c)
+#endif
+
+/* Name the trampoline of SIZE bytes at CODE after the closure of CIF
+   with handler FUN in the perf map file, if it is being written.  */
+void ffi_perf_map_closure (void *code, size_t size, const ffi_cif *cif,
+			   void *fun) FFI_HIDDEN;
+
+#ifdef FFI_TARGET_HAS_EXEC_CFI
+/* The size of the unwind info built by ffi_exec_cfi_machdep.  */
+#define FFI_EXEC_CFI_SIZE 56
+/* Fill in FRAME, aligned to 8 bytes, with an .eh_frame section that
+   describes the LENGTH bytes of closure trampolines at CODE.  */
+void ffi_exec_cfi_machdep (void *frame, void *code, size_t length) FFI_HIDDEN;
+#endif
+
+#ifdef FFI_TARGET_HAS_RECORD
+/* Nonzero while ffi_record_start is writing a trace.  */
+extern int ffi_record_active FFI_HIDDEN;
+/* Add a call, or if CLOSURE an invocation of a closure, of CIF to the
+   trace.  */
+void ffi_record_event (const ffi_cif *cif, int closure) FFI_HIDDEN;
+#define FFI_RECORD(cif, closure) \
+  do { if (ffi_record_active) ffi_record_event (cif, closure); } while (0)
+#endif
+
 /* v cast to size_t and aligned up to a multiple of a */
 #define FFI_ALIGN(v, a)  (((((size_t) (v))-1) | ((a)-1))+1)
 /* v cast to size_t and aligned down to a multiple of a */
@@ -83,6 +117,138 @@ void ffi_type_test(ffi_type *a, char *file, int line);
 ffi_status ffi_prep_cif_machdep(ffi_cif *cif);
 ffi_status ffi_prep_cif_machdep_var(ffi_cif *cif,
 	 unsigned int nfixedargs, unsigned int ntotalargs);
+#ifdef FFI_TARGET_HAS_VAR_TAIL
+/* Record in VCIF->state what ffi_prep_cif_var_tail_machdep needs to
+   carry on after the fixed arguments.  */
+void ffi_prep_var_cif_machdep(ffi_var_cif *vcif) FFI_HIDDEN;
+/* Finish CIF, a copy of VCIF->fixed with the variadic argument types
+   added, examining only those.  Returns a status other than FFI_OK if
+   this is not possible, in which case CIF is prepared from scratch.  */
+ffi_status ffi_prep_cif_var_tail_machdep(ffi_cif *cif,
+					 const ffi_var_cif *vcif) FFI_HIDDEN;
+#endif
+
+#ifdef FFI_TARGET_HAS_CIF_INFO
+/* State of a cif kept in the side table of cifinfo.c.  */
+typedef struct ffi_cif_info
+{
+  struct ffi_cif_info *next;
+  const ffi_cif *cif;
+  /* The signature of CIF when the entry was made for it.  */
+  ffi_abi abi;
+  unsigned nargs;
+  ffi_type *rtype;
+  ffi_type **arg_types;
+  unsigned bytes;
+  ffi_hooks hooks;
+  /* The plan that calls go through once the cif is hot, see
+     ffi_tier_count.  */
+  ffi_plan *plan;
+  int counting;
+  unsigned long long calls;
+  unsigned long long closure_calls;
+  unsigned long long ticks;
+} ffi_cif_info;
+
+/* Return the entry of CIF, or NULL if it has none or the entry was
+   made for another signature.  */
+ffi_cif_info *ffi_cif_info_find (const ffi_cif *cif) FFI_HIDDEN;
+/* Free the entry of a cif that is being prepared or released.  */
+void ffi_cif_info_reset (const ffi_cif *cif) FFI_HIDDEN;
+/* Whether CIF has hooks or is being counted.  */
+int ffi_cif_info_observed (const ffi_cif *cif) FFI_HIDDEN;
+
+#define FFI_CIF_INFO_CALL	0
+#define FFI_CIF_INFO_CLOSURE	1
+
+/* Store the entry of CIF, or NULL, in *INFOP.  Run its before hook for
+   a call or a closure invocation, as WHICH says, and return the time
+   it starts at, if it is counted.  */
+unsigned long long ffi_cif_info_enter (ffi_cif *cif, int which,
+				       ffi_cif_info **infop) FFI_HIDDEN;
+/* Count the call or closure invocation that started at START and run
+   the after hook of INFO, which may be NULL.  */
+void ffi_cif_info_leave (ffi_cif_info *info, ffi_cif *cif, int which,
+			 unsigned long long start) FFI_HIDDEN;
+
+/* Calls are counted per cif, approximately, in a small table indexed
+   by the address of the cif.  A cif that reaches ffi_tier_threshold
+   calls is handed to ffi_tier_up, which lowers it into a plan kept in
+   its entry and marks it.  The slot then points at the entry, so that
+   ffi_tier_plan finds the plan without searching the side table.  */
+#define FFI_TIER_SLOTS 1024
+
+typedef struct
+{
+  const ffi_cif *cif;
+  unsigned count;
+  ffi_cif_info *info;
+} ffi_tier_slot;
+
+extern unsigned ffi_tier_threshold FFI_HIDDEN;
+extern ffi_tier_slot ffi_tier_slots[FFI_TIER_SLOTS] FFI_HIDDEN;
+void ffi_tier_up (ffi_cif *cif) FFI_HIDDEN;
+
+static inline ffi_tier_slot *
+ffi_tier_slot_of (const ffi_cif *cif)
+{
+  size_t h = (size_t) cif >> 4;
+
+  return &ffi_tier_slots[(h ^ (h >> 10)) % FFI_TIER_SLOTS];
+}
+
+/* Count a call of CIF, which is not marked.  Tiering is off unless a
+   threshold was set, so that calls do not share the table otherwise.
+   The count is not incremented atomically: a call that is lost, or two
+   cifs of one slot that are called in turn and keep resetting it, only
+   delay a promotion, and ffi_tier_up copes with being called twice.  */
+static inline void
+ffi_tier_count (ffi_cif *cif)
+{
+  ffi_tier_slot *slot = ffi_tier_slot_of (cif);
+  unsigned threshold = __atomic_load_n (&ffi_tier_threshold,
+					__ATOMIC_RELAXED);
+  unsigned count;
+
+  if (threshold == 0)
+    return;
+  if (__atomic_load_n (&slot->cif, __ATOMIC_RELAXED) != cif)
+    {
+      __atomic_store_n (&slot->cif, cif, __ATOMIC_RELAXED);
+      count = 0;
+    }
+  else
+    count = __atomic_load_n (&slot->count, __ATOMIC_RELAXED);
+  __atomic_store_n (&slot->count, ++count, __ATOMIC_RELAXED);
+  if (count == threshold)
+    ffi_tier_up (cif);
+}
+
+/* The plan of CIF, if CIF was promoted, its slot still points at its
+   entry, and no hooks or counting need the ordinary path; else NULL.
+   The entry is matched against the signature of CIF as in
+   ffi_cif_info_find.  */
+static inline ffi_plan *
+ffi_tier_plan (const ffi_cif *cif)
+{
+  ffi_cif_info *info = __atomic_load_n (&ffi_tier_slot_of (cif)->info,
+					__ATOMIC_ACQUIRE);
+
+  if (info == NULL || __atomic_load_n (&info->cif, __ATOMIC_RELAXED) != cif
+      || info->abi != cif->abi || info->nargs != cif->nargs
+      || info->rtype != cif->rtype || info->arg_types != cif->arg_types
+      || info->bytes != cif->bytes
+      || info->hooks.before_call || info->hooks.after_call
+      || info->counting)
+    return NULL;
+  return __atomic_load_n (&info->plan, __ATOMIC_ACQUIRE);
+}
+
+/* Mark CIF as having state that its calls and closures must look up,
+   if ACTIVE, or clear the mark.  Returns FFI_BAD_ABI if the target
+   cannot do this for CIF.  */
+ffi_status ffi_cif_info_machdep (ffi_cif *cif, int active) FFI_HIDDEN;
+#endif
 
 
 #if HAVE_LONG_DOUBLE_VARIANT
@@ -111,6 +277,78 @@ typedef struct
   void **avalue;
 } extended_cif;
 
+/* A call plan is the architecture-neutral, lowered form of an ffi_cif.
+   Targets that define FFI_TARGET_HAS_PLAN translate a prepared cif
+   into a list of steps, each of which moves one piece of one argument
+   into a "call image": a block of memory laid out the way the
+   target's assembly call routine expects to find it.  The steps are
+   executed by the generic interpreter in plan.c; the target only
+   supplies the lowering and the routine that performs the call.  */
+
+enum ffi_plan_op
+{
+  FFI_PLAN_COPY,	/* Copy SIZE bytes.  */
+  FFI_PLAN_SLOT,	/* Clear an ffi_arg slot, then copy SIZE bytes.  */
+  FFI_PLAN_SINT8,	/* Sign-extend into an ffi_arg slot.  */
+  FFI_PLAN_SINT16,
+  FFI_PLAN_SINT32,
+  FFI_PLAN_RVALUE,	/* Store the return value address in a slot.  */
+  FFI_PLAN_CONST	/* Store the constant SRC in an ffi_arg slot.  */
+};
+
+typedef struct
+{
+  unsigned op;		/* One of enum ffi_plan_op.  */
+  unsigned arg;		/* Index into avalue.  */
+  unsigned src;		/* Byte offset within the argument.  */
+  unsigned dst;		/* Byte offset within the call image.  */
+  unsigned size;	/* Number of bytes moved.  */
+} ffi_plan_step;
+
+struct ffi_plan
+{
+  ffi_cif *cif;
+  /* Nonzero if the target lowered the cif; otherwise calls go through
+     ffi_call.  */
+  unsigned lowered;
+  /* Target-private call flags.  */
+  unsigned flags;
+  /* Size of the call image, including any scratch the target's call
+     routine needs past the end of the outgoing arguments.  */
+  size_t image_size;
+  /* Size of the return value when it is returned in memory, else 0.  */
+  size_t rsize;
+  /* For a plan with bound arguments, a copy of each bound value, or
+     NULL for the arguments that vary; otherwise NULL.  */
+  void **bound;
+  /* For a lowered plan with bound arguments, the call image with the
+     bound arguments and constants already in place.  It is copied into
+     each call's image before the remaining steps run.  */
+  char *image_init;
+  unsigned nsteps;
+  ffi_plan_step steps[];
+};
+
+/* Upper bound on the number of steps a target may emit for a cif with
+   NARGS arguments.  */
+#define FFI_PLAN_MAX_STEPS(nargs)	((nargs) * 4 + 4)
+
+/* Execute the steps of PLAN, filling IMAGE.  If PLAN has an initial
+   image, the caller must have copied it into IMAGE first.  */
+void ffi_plan_run (const ffi_plan *plan, char *image, void *rvalue,
+		   void **avalue) FFI_HIDDEN;
+
+#ifdef FFI_TARGET_HAS_PLAN
+/* Lower PLAN->cif into PLAN.  Returns FFI_OK on success, or another
+   status if the cif cannot be lowered, in which case the plan falls
+   back to ffi_call.  */
+ffi_status ffi_prep_plan_machdep (ffi_plan *plan) FFI_HIDDEN;
+/* Allocate a call image, copy in PLAN->image_init if there is one, run
+   the plan into it and perform the call.  */
+void ffi_call_plan_machdep (const ffi_plan *plan, void (*fn)(void),
+			    void *rvalue, void **avalue) FFI_HIDDEN;
+#endif
+
 /* Terse sized type definitions.  */
 #if defined(_MSC_VER) || defined(__sgi) || defined(__SUNPRO_C)
 typedef unsigned char UINT8;
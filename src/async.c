@@ -0,0 +1,186 @@
+/* -----------------------------------------------------------------------
+   async.c - Copyright (c) 2026  libffi contributors
+
+   Calls run on a pool of worker threads.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include <ffi.h>
+#include <ffi_common.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+
+#include <pthread.h>
+#include <signal.h>
+
+/* The most worker threads started.  The called functions are expected
+   to block, so this is not tied to the number of processors.  */
+#define ASYNC_MAX_WORKERS 8
+
+/* A queued call.  The arguments follow in a packed block, at
+   ARGS_OFFSET from the start of the job so that they are aligned
+   whatever alignment malloc gives.  */
+typedef struct ffi_async_job
+{
+  struct ffi_async_job *next;
+  ffi_cif *cif;
+  void (*fn)(void);
+  void *rvalue;
+  ffi_async_done done;
+  void *user_data;
+  size_t args_offset;
+} ffi_async_job;
+
+static pthread_mutex_t async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_cond = PTHREAD_COND_INITIALIZER;
+static ffi_async_job *async_head;
+static ffi_async_job **async_tail = &async_head;
+static unsigned async_workers, async_idle, async_queued;
+
+static void *
+async_worker (void *arg)
+{
+  (void) arg;
+
+  pthread_mutex_lock (&async_lock);
+  for (;;)
+    {
+      ffi_async_job *job;
+
+      while (async_head == NULL)
+	{
+	  async_idle++;
+	  pthread_cond_wait (&async_cond, &async_lock);
+	  async_idle--;
+	}
+
+      job = async_head;
+      async_head = job->next;
+      if (async_head == NULL)
+	async_tail = &async_head;
+      async_queued--;
+      pthread_mutex_unlock (&async_lock);
+
+      ffi_call_packed (job->cif, job->fn, job->rvalue,
+		       (char *) job + job->args_offset);
+      job->done (job->cif, job->rvalue, job->user_data);
+      free (job);
+
+      pthread_mutex_lock (&async_lock);
+    }
+
+  return NULL;
+}
+
+/* Start another worker.  Called with async_lock held.  The workers
+   block all signals, so that those meant for the thread that queued
+   the call are not delivered to a worker instead.  */
+
+static int
+async_start_worker (void)
+{
+  pthread_attr_t attr;
+  pthread_t thread;
+  sigset_t all, old;
+  int err;
+
+  if (pthread_attr_init (&attr) != 0)
+    return -1;
+  pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+
+  sigfillset (&all);
+  pthread_sigmask (SIG_SETMASK, &all, &old);
+  err = pthread_create (&thread, &attr, async_worker, NULL);
+  pthread_sigmask (SIG_SETMASK, &old, NULL);
+  pthread_attr_destroy (&attr);
+
+  if (err != 0)
+    return -1;
+  async_workers++;
+  return 0;
+}
+
+ffi_status
+ffi_call_async (ffi_cif *cif, void (*fn)(void), void *rvalue,
+		void **avalue, ffi_async_done done, void *user_data)
+{
+  ffi_async_job *job;
+  size_t align = 1, size, off;
+  unsigned i;
+
+  for (i = 0; i < cif->nargs; i++)
+    if (cif->arg_types[i]->alignment > align)
+      align = cif->arg_types[i]->alignment;
+  ffi_get_packed_offsets (cif, NULL, &size);
+
+  job = malloc (sizeof (ffi_async_job) + align - 1 + size);
+  if (job == NULL)
+    return FFI_BAD_ABI;
+  job->cif = cif;
+  job->fn = fn;
+  job->rvalue = rvalue;
+  job->done = done;
+  job->user_data = user_data;
+  job->args_offset = FFI_ALIGN ((size_t) (job + 1), align) - (size_t) job;
+
+  /* Marshal the arguments straight into the block the worker calls
+     from.  */
+  for (i = 0, off = 0; i < cif->nargs; i++)
+    {
+      ffi_type *type = cif->arg_types[i];
+
+      off = FFI_ALIGN (off, type->alignment);
+      memcpy ((char *) job + job->args_offset + off, avalue[i], type->size);
+      off += type->size;
+    }
+
+  job->next = NULL;
+  pthread_mutex_lock (&async_lock);
+  if (async_idle <= async_queued && async_workers < ASYNC_MAX_WORKERS
+      && async_start_worker () != 0 && async_workers == 0)
+    {
+      pthread_mutex_unlock (&async_lock);
+      free (job);
+      return FFI_BAD_ABI;
+    }
+  *async_tail = job;
+  async_tail = &job->next;
+  async_queued++;
+  pthread_cond_signal (&async_cond);
+  pthread_mutex_unlock (&async_lock);
+
+  return FFI_OK;
+}
+
+#else
+
+ffi_status
+ffi_call_async (ffi_cif *cif MAYBE_UNUSED, void (*fn)(void) MAYBE_UNUSED,
+		void *rvalue MAYBE_UNUSED, void **avalue MAYBE_UNUSED,
+		ffi_async_done done MAYBE_UNUSED, void *user_data MAYBE_UNUSED)
+{
+  return FFI_BAD_ABI;
+}
+
+#endif
@@ -0,0 +1,735 @@
+/* -----------------------------------------------------------------------
+   cifcache.c - Copyright (c) 2026  libffi contributors
+
+   Files of prepared cifs that are mapped instead of prepared again.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include <ffi.h>
+#include <ffi_common.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CIF_CACHE_MMAP 1
+#endif
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+/* A cache file is an image of the cifs, as ffi_prep_cif left them, and
+   of the types they refer to, laid out as this build of libffi lays
+   them out in memory:
+
+     header
+     ffi_cif cifs[ncifs]
+     the ffi_type objects and the argument and element arrays
+
+   Each pointer in the image is stored encoded: 0 for NULL, the offset
+   of its target from the start of the file plus one, or, for the
+   predefined types, four times the index of the type in cache_builtins
+   plus three.  A pointer is decoded in place the first time the cif it
+   belongs to is asked for, so only the pages of the cifs that a process
+   uses are copied; which pointers have been decoded is kept apart from
+   the image, since the file could hold any value.
+
+   Everything else in the cifs, including the flags and stack size
+   computed by the target, is used as it is, so a cache is only
+   accepted by a build that prepares cifs the same way.  The header
+   records a fingerprint of the cifs that the writing build prepares for
+   a fixed set of signatures, which changes with the target's flag
+   layout and classification even where the version does not.  */
+
+#define CIF_CACHE_MAGIC "fficac2"
+#define CIF_CACHE_ALIGN 8
+
+typedef struct
+{
+  char magic[8];
+  char version[16];
+  uint32_t byte_order;
+  uint16_t cif_size;
+  uint16_t type_size;
+  uint16_t pointer_size;
+  uint16_t default_abi;
+  uint32_t fingerprint;
+  uint32_t ncifs;
+  uint64_t size;
+} cif_cache_header;
+
+#define CIF_CACHE_CIFS \
+  ((sizeof (cif_cache_header) + CIF_CACHE_ALIGN - 1) & -CIF_CACHE_ALIGN)
+
+/* Struct types nest at most this deep in a cache.  */
+#define CIF_CACHE_MAX_DEPTH 64
+
+struct ffi_cif_cache
+{
+  char *base;
+  size_t size;
+  unsigned ncifs;
+  int mapped;
+  /* Nonzero for each cif whose pointers have all been decoded.  */
+  unsigned char *ready;
+  /* One bit for each pointer-sized word of the image, set once the
+     pointer there has been decoded.  */
+  unsigned char *decoded;
+#if !defined(_WIN32)
+  pthread_mutex_t lock;
+#else
+  char lock;
+#endif
+};
+
+static ffi_type *const cache_builtins[] = {
+  &ffi_type_void,
+  &ffi_type_uint8, &ffi_type_sint8,
+  &ffi_type_uint16, &ffi_type_sint16,
+  &ffi_type_uint32, &ffi_type_sint32,
+  &ffi_type_uint64, &ffi_type_sint64,
+  &ffi_type_float, &ffi_type_double,
+  &ffi_type_pointer, &ffi_type_longdouble,
+#ifdef FFI_TARGET_HAS_COMPLEX_TYPE
+  &ffi_type_complex_float, &ffi_type_complex_double,
+  &ffi_type_complex_longdouble,
+#endif
+};
+
+#define CACHE_NBUILTINS (sizeof (cache_builtins) / sizeof (cache_builtins[0]))
+
+static uint32_t
+fingerprint_add (uint32_t h, uint32_t v)
+{
+  unsigned i;
+
+  for (i = 0; i < 4; i++, v >>= 8)
+    h = (h ^ (v & 0xff)) * 16777619u;
+  return h;
+}
+
+static uint32_t
+fingerprint_cif (uint32_t h, ffi_status status, const ffi_cif *cif)
+{
+  h = fingerprint_add (h, status);
+  if (status == FFI_OK)
+    {
+      h = fingerprint_add (h, cif->bytes);
+      h = fingerprint_add (h, cif->flags);
+    }
+  return h;
+}
+
+/* Prepare a fixed set of signatures that covers the classes of
+   arguments and return values, and hash what the target computed for
+   them.  */
+
+static uint32_t
+cache_fingerprint (void)
+{
+  static uint32_t fingerprint;
+  uint32_t h = __atomic_load_n (&fingerprint, __ATOMIC_RELAXED);
+  ffi_type mixed, floats, big;
+  ffi_type *mixed_elements[3], *floats_elements[4], *big_elements[5];
+  ffi_type *args[18];
+  ffi_cif cif;
+  unsigned i;
+
+  if (h != 0)
+    return h;
+  h = 2166136261u;
+
+  mixed.size = mixed.alignment = 0;
+  mixed.type = FFI_TYPE_STRUCT;
+  mixed.elements = mixed_elements;
+  mixed_elements[0] = &ffi_type_sint8;
+  mixed_elements[1] = &ffi_type_double;
+  mixed_elements[2] = NULL;
+  floats.size = floats.alignment = 0;
+  floats.type = FFI_TYPE_STRUCT;
+  floats.elements = floats_elements;
+  floats_elements[0] = &ffi_type_float;
+  floats_elements[1] = &ffi_type_float;
+  floats_elements[2] = &ffi_type_float;
+  floats_elements[3] = NULL;
+  big.size = big.alignment = 0;
+  big.type = FFI_TYPE_STRUCT;
+  big.elements = big_elements;
+  big_elements[0] = &ffi_type_sint64;
+  big_elements[1] = &ffi_type_sint64;
+  big_elements[2] = &ffi_type_sint64;
+  big_elements[3] = &ffi_type_double;
+  big_elements[4] = NULL;
+
+  h = fingerprint_cif (h, ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 0,
+					&ffi_type_void, args), &cif);
+  args[0] = &ffi_type_sint8;
+  args[1] = &ffi_type_uint16;
+  args[2] = &ffi_type_sint64;
+  args[3] = &ffi_type_pointer;
+  h = fingerprint_cif (h, ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 4,
+					&ffi_type_sint32, args), &cif);
+  args[0] = &ffi_type_float;
+  args[1] = &ffi_type_double;
+  h = fingerprint_cif (h, ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 2,
+					&ffi_type_float, args), &cif);
+  args[0] = &ffi_type_longdouble;
+  h = fingerprint_cif (h, ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 1,
+					&ffi_type_longdouble, args), &cif);
+  args[0] = &floats;
+  args[1] = &ffi_type_sint32;
+  h = fingerprint_cif (h, ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 2,
+					&mixed, args), &cif);
+  args[0] = &big;
+  args[1] = &mixed;
+  args[2] = &ffi_type_double;
+  h = fingerprint_cif (h, ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 3,
+					&big, args), &cif);
+  args[0] = &ffi_type_sint32;
+  args[1] = &ffi_type_double;
+  args[2] = &ffi_type_double;
+  h = fingerprint_cif (h, ffi_prep_cif_var (&cif, FFI_DEFAULT_ABI, 1, 3,
+					    &ffi_type_double, args), &cif);
+  for (i = 0; i < 18; i++)
+    args[i] = i % 2 ? &ffi_type_double : &ffi_type_sint64;
+  h = fingerprint_cif (h, ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 18,
+					&ffi_type_sint64, args), &cif);
+#ifdef FFI_TARGET_HAS_COMPLEX_TYPE
+  args[0] = &ffi_type_complex_float;
+  args[1] = &ffi_type_complex_double;
+  h = fingerprint_cif (h, ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 2,
+					&ffi_type_complex_double, args), &cif);
+#endif
+
+  if (h == 0)
+    h = 1;
+  __atomic_store_n (&fingerprint, h, __ATOMIC_RELAXED);
+  return h;
+}
+
+static void
+cache_fill_header (cif_cache_header *h)
+{
+  memset (h, 0, sizeof (*h));
+  memcpy (h->magic, CIF_CACHE_MAGIC, sizeof (CIF_CACHE_MAGIC));
+  strncpy (h->version, PACKAGE_VERSION, sizeof (h->version) - 1);
+  h->byte_order = 0x01020304;
+  h->cif_size = sizeof (ffi_cif);
+  h->type_size = sizeof (ffi_type);
+  h->pointer_size = sizeof (void *);
+  h->default_abi = FFI_DEFAULT_ABI;
+  h->fingerprint = cache_fingerprint ();
+}
+
+/* Writing.  The image is built in memory first, at offsets, since it
+   moves as it grows.  */
+
+typedef struct
+{
+  const ffi_type *type;
+  size_t offset;
+} cache_type_entry;
+
+typedef struct
+{
+  char *data;
+  size_t size, alloc;
+  /* The types copied so far, and where to, hashed by address.  */
+  cache_type_entry *types;
+  size_t ntypes, types_mask;
+  int failed;
+} cache_writer;
+
+/* Reserve SIZE zeroed bytes at the end of the image and return their
+   offset, or 0 on failure.  */
+
+static size_t
+writer_reserve (cache_writer *w, size_t size)
+{
+  size_t off = (w->size + CIF_CACHE_ALIGN - 1) & -CIF_CACHE_ALIGN;
+  size_t n = w->alloc ? w->alloc : 4096;
+  char *p;
+
+  if (w->failed)
+    return 0;
+  if (off + size > w->alloc)
+    {
+      while (n < off + size)
+	n *= 2;
+      p = realloc (w->data, n);
+      if (p == NULL)
+	{
+	  w->failed = 1;
+	  return 0;
+	}
+      w->data = p;
+      w->alloc = n;
+    }
+  memset (w->data + w->size, 0, off + size - w->size);
+  w->size = off + size;
+  return off;
+}
+
+static cache_type_entry *
+writer_lookup (cache_writer *w, const ffi_type *t)
+{
+  size_t h = ((size_t) t >> 3) & w->types_mask;
+
+  while (w->types[h].type != NULL && w->types[h].type != t)
+    h = (h + 1) & w->types_mask;
+  return &w->types[h];
+}
+
+static int
+writer_grow_types (cache_writer *w)
+{
+  cache_type_entry *old = w->types;
+  size_t n = w->types_mask + 1, i;
+
+  if (old != NULL && 2 * (w->ntypes + 1) <= n)
+    return 1;
+  n = old != NULL ? 2 * n : 64;
+  w->types = calloc (n, sizeof (cache_type_entry));
+  if (w->types == NULL)
+    {
+      w->types = old;
+      return 0;
+    }
+  w->types_mask = n - 1;
+  if (old != NULL)
+    {
+      for (i = 0; i < n / 2; i++)
+	if (old[i].type != NULL)
+	  *writer_lookup (w, old[i].type) = old[i];
+      free (old);
+    }
+  return 1;
+}
+
+static void
+writer_pointer (cache_writer *w, size_t slot, uintptr_t value)
+{
+  if (!w->failed)
+    memcpy (w->data + slot, &value, sizeof (value));
+}
+
+static uintptr_t writer_type (cache_writer *w, const ffi_type *t);
+
+/* Copy the N types of TYPES into a NULL-terminated array.  */
+
+static uintptr_t
+writer_array (cache_writer *w, ffi_type *const *types, size_t n)
+{
+  size_t off = writer_reserve (w, (n + 1) * sizeof (ffi_type *)), i;
+
+  for (i = 0; i < n && !w->failed; i++)
+    writer_pointer (w, off + i * sizeof (ffi_type *),
+		    writer_type (w, types[i]));
+  return off + 1;
+}
+
+/* Return the encoded pointer to T, copying it into the image first if
+   it is not there yet.  */
+
+static uintptr_t
+writer_type (cache_writer *w, const ffi_type *t)
+{
+  cache_type_entry *e;
+  size_t off, n;
+  ffi_type copy;
+  unsigned i;
+
+  if (t == NULL)
+    return 0;
+  for (i = 0; i < CACHE_NBUILTINS; i++)
+    if (cache_builtins[i] == t)
+      return 4 * (uintptr_t) i + 3;
+
+  if (w->failed || !writer_grow_types (w))
+    {
+      w->failed = 1;
+      return 0;
+    }
+  e = writer_lookup (w, t);
+  if (e->type != NULL)
+    return e->offset + 1;
+
+  off = writer_reserve (w, sizeof (ffi_type));
+  if (w->failed)
+    return 0;
+  e->type = t;
+  e->offset = off;
+  w->ntypes++;
+
+  copy = *t;
+  copy.elements = NULL;
+  memcpy (w->data + off, &copy, sizeof (copy));
+  if (t->elements != NULL)
+    {
+      for (n = 0; t->elements[n] != NULL; n++)
+	;
+      writer_pointer (w, off + offsetof (ffi_type, elements),
+		      writer_array (w, t->elements, n));
+    }
+  return off + 1;
+}
+
+ffi_status
+ffi_cif_cache_write (const char *path, ffi_cif *const *cifs, unsigned ncifs)
+{
+  cache_writer w;
+  cif_cache_header h;
+  unsigned i;
+  FILE *f;
+
+  memset (&w, 0, sizeof (w));
+  writer_reserve (&w, CIF_CACHE_CIFS);
+  writer_reserve (&w, (size_t) ncifs * sizeof (ffi_cif));
+
+  for (i = 0; i < ncifs && !w.failed; i++)
+    {
+      size_t off = CIF_CACHE_CIFS + (size_t) i * sizeof (ffi_cif);
+      ffi_cif copy = *cifs[i];
+
+      /* Hooks, counts and plans belong to the process, not to the
+	 signature.  */
+#ifdef FFI_TARGET_HAS_CIF_INFO
+      ffi_cif_info_machdep (&copy, 0);
+#endif
+      copy.arg_types = NULL;
+      copy.rtype = NULL;
+      memcpy (w.data + off, &copy, sizeof (copy));
+      writer_pointer (&w, off + offsetof (ffi_cif, rtype),
+		      writer_type (&w, cifs[i]->rtype));
+      if (cifs[i]->nargs > 0)
+	writer_pointer (&w, off + offsetof (ffi_cif, arg_types),
+			writer_array (&w, cifs[i]->arg_types,
+				      cifs[i]->nargs));
+    }
+
+  if (!w.failed)
+    {
+      cache_fill_header (&h);
+      h.ncifs = ncifs;
+      h.size = w.size;
+      memcpy (w.data, &h, sizeof (h));
+
+      f = fopen (path, "wb");
+      if (f == NULL)
+	w.failed = 1;
+      else
+	{
+	  if (fwrite (w.data, 1, w.size, f) != w.size)
+	    w.failed = 1;
+	  if (fclose (f) != 0)
+	    w.failed = 1;
+	}
+    }
+
+  free (w.data);
+  free (w.types);
+  return w.failed ? FFI_BAD_ABI : FFI_OK;
+}
+
+/* Reading.  Cifs are decoded under the lock of the cache, since they
+   share types; a cif that is ready is only read, and decoding another
+   one only writes the pointers that have not been decoded yet.  */
+
+static void
+cache_lock (ffi_cif_cache *cache)
+{
+#if !defined(_WIN32)
+  pthread_mutex_lock (&cache->lock);
+#else
+  while (__atomic_test_and_set (&cache->lock, __ATOMIC_ACQUIRE))
+    ;
+#endif
+}
+
+static void
+cache_unlock (ffi_cif_cache *cache)
+{
+#if !defined(_WIN32)
+  pthread_mutex_unlock (&cache->lock);
+#else
+  __atomic_clear (&cache->lock, __ATOMIC_RELEASE);
+#endif
+}
+
+static int cache_decode_type (ffi_cif_cache *cache, ffi_type *t,
+			      unsigned depth);
+
+/* Decode the pointer at SLOT, which points to an object of SIZE bytes,
+   and store it in *P.  Returns 0 if the pointer is not a valid encoded
+   one.  */
+
+static int
+cache_decode (ffi_cif_cache *cache, void *slot, size_t size, void **p)
+{
+  size_t word = ((char *) slot - cache->base) / sizeof (void *);
+  unsigned char bit = 1 << (word % 8);
+  uintptr_t v = *(uintptr_t *) slot;
+
+  if (cache->decoded[word / 8] & bit)
+    {
+      *p = (void *) v;
+      return 1;
+    }
+  if (v == 0)
+    *p = NULL;
+  else if ((v & 1) == 0)
+    return 0;
+  else if (v & 2)
+    {
+      if (v / 4 >= CACHE_NBUILTINS)
+	return 0;
+      *p = cache_builtins[v / 4];
+    }
+  else
+    {
+      v--;
+      if (v < CIF_CACHE_CIFS || v % CIF_CACHE_ALIGN != 0
+	  || v > cache->size || cache->size - v < size)
+	return 0;
+      *p = cache->base + v;
+    }
+  *(void **) slot = *p;
+  cache->decoded[word / 8] |= bit;
+  return 1;
+}
+
+/* Decode the N pointers to types of ARRAY, or up to a NULL one if N is
+   (size_t) -1.  */
+
+static int
+cache_decode_array (ffi_cif_cache *cache, ffi_type **array, size_t n,
+		    unsigned depth)
+{
+  char *end = cache->base + cache->size;
+  size_t i;
+  void *t;
+
+  for (i = 0; i < n; i++)
+    {
+      if ((char *) (array + i + 1) > end
+	  || !cache_decode (cache, &array[i], sizeof (ffi_type), &t))
+	return 0;
+      if (t == NULL)
+	return n == (size_t) -1;
+      if (!cache_decode_type (cache, t, depth))
+	return 0;
+    }
+  return 1;
+}
+
+static int
+cache_decode_type (ffi_cif_cache *cache, ffi_type *t, unsigned depth)
+{
+  void *elements;
+  unsigned i;
+
+  for (i = 0; i < CACHE_NBUILTINS; i++)
+    if (cache_builtins[i] == t)
+      return 1;
+  if (depth >= CIF_CACHE_MAX_DEPTH
+      || !cache_decode (cache, &t->elements, sizeof (ffi_type *), &elements))
+    return 0;
+  return (elements == NULL
+	  || cache_decode_array (cache, elements, (size_t) -1, depth + 1));
+}
+
+ffi_cif_cache *
+ffi_cif_cache_open (const char *path)
+{
+  ffi_cif_cache *cache = malloc (sizeof (ffi_cif_cache));
+  const cif_cache_header *h;
+  cif_cache_header expect;
+  unsigned i;
+#ifdef CIF_CACHE_MMAP
+  struct stat st;
+  int fd;
+#else
+  FILE *f;
+  long n;
+#endif
+
+  if (cache == NULL)
+    return NULL;
+  cache->base = NULL;
+  cache->ready = NULL;
+  cache->decoded = NULL;
+
+#ifdef CIF_CACHE_MMAP
+  fd = open (path, O_RDONLY);
+  if (fd < 0)
+    goto fail;
+  if (fstat (fd, &st) != 0 || st.st_size < (off_t) CIF_CACHE_CIFS)
+    {
+      close (fd);
+      goto fail;
+    }
+  cache->size = st.st_size;
+  /* Private, so that decoding the pointers of a cif, or preparing a
+     closure or a plan for it, only copies the pages it touches.  */
+  cache->base = mmap (NULL, cache->size, PROT_READ | PROT_WRITE,
+		      MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (cache->base == MAP_FAILED)
+    {
+      cache->base = NULL;
+      goto fail;
+    }
+  cache->mapped = 1;
+#else
+  f = fopen (path, "rb");
+  if (f == NULL)
+    goto fail;
+  if (fseek (f, 0, SEEK_END) != 0 || (n = ftell (f)) < (long) CIF_CACHE_CIFS
+      || fseek (f, 0, SEEK_SET) != 0
+      || (cache->base = malloc (n)) == NULL
+      || fread (cache->base, 1, n, f) != (size_t) n)
+    {
+      fclose (f);
+      goto fail;
+    }
+  fclose (f);
+  cache->size = n;
+  cache->mapped = 0;
+#endif
+
+  h = (const cif_cache_header *) cache->base;
+  cache_fill_header (&expect);
+  if (memcmp (h->magic, expect.magic, sizeof (h->magic)) != 0
+      || memcmp (h->version, expect.version, sizeof (h->version)) != 0
+      || h->byte_order != expect.byte_order
+      || h->cif_size != expect.cif_size
+      || h->type_size != expect.type_size
+      || h->pointer_size != expect.pointer_size
+      || h->default_abi != expect.default_abi
+      || h->fingerprint != expect.fingerprint
+      || h->size != cache->size
+      || h->ncifs > (cache->size - CIF_CACHE_CIFS) / sizeof (ffi_cif))
+    goto fail;
+  cache->ncifs = h->ncifs;
+  cache->ready = calloc (cache->ncifs + 1, 1);
+  cache->decoded = calloc (cache->size / sizeof (void *) / 8 + 1, 1);
+  if (cache->ready == NULL || cache->decoded == NULL)
+    goto fail;
+#if !defined(_WIN32)
+  pthread_mutex_init (&cache->lock, NULL);
+#else
+  cache->lock = 0;
+#endif
+
+  /* The mapping may be where a cif that has state used to be.  */
+#ifdef FFI_TARGET_HAS_CIF_INFO
+  for (i = 0; i < cache->ncifs; i++)
+    ffi_cif_info_reset ((ffi_cif *) (cache->base + CIF_CACHE_CIFS) + i);
+#else
+  (void) i;
+#endif
+  return cache;
+
+ fail:
+  if (cache->base != NULL)
+    {
+#ifdef CIF_CACHE_MMAP
+      munmap (cache->base, cache->size);
+#else
+      free (cache->base);
+#endif
+    }
+  free (cache->ready);
+  free (cache->decoded);
+  free (cache);
+  return NULL;
+}
+
+unsigned
+ffi_cif_cache_count (const ffi_cif_cache *cache)
+{
+  return cache->ncifs;
+}
+
+ffi_cif *
+ffi_cif_cache_cif (ffi_cif_cache *cache, unsigned i)
+{
+  ffi_cif *cif;
+  void *p;
+
+  if (i >= cache->ncifs)
+    return NULL;
+  cif = (ffi_cif *) (cache->base + CIF_CACHE_CIFS) + i;
+  if (__atomic_load_n (&cache->ready[i], __ATOMIC_ACQUIRE))
+    return cif;
+
+  cache_lock (cache);
+  if (!cache->ready[i])
+    {
+      if (!cache_decode (cache, &cif->rtype, sizeof (ffi_type), &p)
+	  || p == NULL || !cache_decode_type (cache, p, 0)
+	  || !cache_decode (cache, &cif->arg_types,
+			    cif->nargs * sizeof (ffi_type *), &p)
+	  || (cif->nargs > 0
+	      && (p == NULL
+		  || !cache_decode_array (cache, p, cif->nargs, 0))))
+	cif = NULL;
+      else
+	{
+#if HAVE_LONG_DOUBLE_VARIANT
+	  ffi_prep_types (cif->abi);
+#endif
+	  __atomic_store_n (&cache->ready[i], 1, __ATOMIC_RELEASE);
+	}
+    }
+  cache_unlock (cache);
+  return cif;
+}
+
+void
+ffi_cif_cache_close (ffi_cif_cache *cache)
+{
+#ifdef FFI_TARGET_HAS_CIF_INFO
+  unsigned i;
+
+  for (i = 0; i < cache->ncifs; i++)
+    ffi_cif_info_reset ((ffi_cif *) (cache->base + CIF_CACHE_CIFS) + i);
+#endif
+#ifdef CIF_CACHE_MMAP
+  if (cache->mapped)
+    munmap (cache->base, cache->size);
+  else
+#endif
+    free (cache->base);
+#if !defined(_WIN32)
+  pthread_mutex_destroy (&cache->lock);
+#endif
+  free (cache->ready);
+  free (cache->decoded);
+  free (cache);
+}
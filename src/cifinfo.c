@@ -0,0 +1,401 @@
+/* -----------------------------------------------------------------------
+   cifinfo.c - Copyright (c) 2026  libffi contributors
+
+   Per-cif state kept outside of ffi_cif.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include <ffi.h>
+#include <ffi_common.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef FFI_TARGET_HAS_CIF_INFO
+
+#include <pthread.h>
+#include <time.h>
+
+/* ffi_cif has no room for more state without changing the ABI, so it
+   is kept in this table, keyed by the address of the cif.  The target
+   marks a cif that has an entry in its flags, and only takes the slow
+   path that looks it up for such cifs.
+
+   Entries are never unlinked, so that lookups need no lock: an entry is
+   filled in before it is published at the head of its bucket.  An entry
+   is freed, by setting its cif to NULL, when its cif is prepared again
+   or released, and is then reused for the next cif of its bucket.
+
+   An entry also records the signature of its cif.  A cif copied over
+   one that was freed without being released carries the mark, but not
+   the signature, so it does not pick up the state left behind.
+
+   Calls read the hooks and the plan of an entry without taking the
+   lock, so a cif must not be in use while it is prepared again or
+   released, when they are dropped.  */
+
+#define CIF_INFO_BUCKETS 4096
+
+static ffi_cif_info *cif_info_table[CIF_INFO_BUCKETS];
+static pthread_mutex_t cif_info_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline ffi_cif_info **
+cif_info_bucket (const ffi_cif *cif)
+{
+  uintptr_t h = (uintptr_t) cif >> 4;
+
+  return &cif_info_table[(h ^ (h >> 12)) % CIF_INFO_BUCKETS];
+}
+
+/* The entry of CIF, whatever signature it was made for.  */
+
+static ffi_cif_info *
+cif_info_find_addr (const ffi_cif *cif)
+{
+  ffi_cif_info *info;
+
+  for (info = __atomic_load_n (cif_info_bucket (cif), __ATOMIC_ACQUIRE);
+       info != NULL; info = info->next)
+    if (__atomic_load_n (&info->cif, __ATOMIC_ACQUIRE) == cif)
+      return info;
+  return NULL;
+}
+
+static int
+cif_info_matches (const ffi_cif_info *info, const ffi_cif *cif)
+{
+  return (info->abi == cif->abi && info->nargs == cif->nargs
+	  && info->rtype == cif->rtype && info->arg_types == cif->arg_types
+	  && info->bytes == cif->bytes);
+}
+
+ffi_cif_info *
+ffi_cif_info_find (const ffi_cif *cif)
+{
+  ffi_cif_info *info = cif_info_find_addr (cif);
+
+  return info != NULL && cif_info_matches (info, cif) ? info : NULL;
+}
+
+/* Free INFO and drop its state.  Called with cif_info_lock held.  */
+
+static void
+cif_info_free (ffi_cif_info *info)
+{
+  ffi_tier_slot *slot = ffi_tier_slot_of (info->cif);
+
+  if (__atomic_load_n (&slot->info, __ATOMIC_RELAXED) == info)
+    __atomic_store_n (&slot->info, NULL, __ATOMIC_RELAXED);
+  __atomic_store_n (&info->cif, NULL, __ATOMIC_RELEASE);
+  if (info->plan != NULL)
+    ffi_plan_free (info->plan);
+  memset ((char *) info + offsetof (ffi_cif_info, hooks), 0,
+	  sizeof (ffi_cif_info) - offsetof (ffi_cif_info, hooks));
+}
+
+static ffi_cif_info *
+cif_info_get (const ffi_cif *cif)
+{
+  ffi_cif_info **bucket = cif_info_bucket (cif);
+  ffi_cif_info *info;
+
+  pthread_mutex_lock (&cif_info_lock);
+  info = cif_info_find_addr (cif);
+  if (info != NULL && !cif_info_matches (info, cif))
+    {
+      /* Left behind by a cif that was freed without being released.  */
+      cif_info_free (info);
+      info = NULL;
+    }
+  if (info == NULL)
+    {
+      for (info = *bucket; info != NULL; info = info->next)
+	if (info->cif == NULL)
+	  break;
+      if (info == NULL && (info = calloc (1, sizeof (ffi_cif_info))) != NULL)
+	{
+	  info->next = *bucket;
+	  __atomic_store_n (bucket, info, __ATOMIC_RELEASE);
+	}
+      if (info != NULL)
+	{
+	  info->abi = cif->abi;
+	  info->nargs = cif->nargs;
+	  info->rtype = cif->rtype;
+	  info->arg_types = cif->arg_types;
+	  info->bytes = cif->bytes;
+	  __atomic_store_n (&info->cif, cif, __ATOMIC_RELEASE);
+	}
+    }
+  pthread_mutex_unlock (&cif_info_lock);
+  return info;
+}
+
+void
+ffi_cif_info_reset (const ffi_cif *cif)
+{
+  ffi_cif_info *info;
+  ffi_tier_slot *slot = ffi_tier_slot_of (cif);
+
+  if (__atomic_load_n (&slot->cif, __ATOMIC_RELAXED) == cif)
+    __atomic_store_n (&slot->count, 0, __ATOMIC_RELAXED);
+  if (cif_info_find_addr (cif) == NULL)
+    return;
+
+  pthread_mutex_lock (&cif_info_lock);
+  info = cif_info_find_addr (cif);
+  if (info != NULL)
+    cif_info_free (info);
+  pthread_mutex_unlock (&cif_info_lock);
+}
+
+void
+ffi_cif_release (ffi_cif *cif)
+{
+  ffi_cif_info_reset (cif);
+  ffi_cif_info_machdep (cif, 0);
+}
+
+static int
+cif_info_observed (const ffi_cif_info *info)
+{
+  const ffi_hooks *h = &info->hooks;
+
+  return (h->before_call || h->after_call
+	  || h->before_closure || h->after_closure || info->counting);
+}
+
+int
+ffi_cif_info_observed (const ffi_cif *cif)
+{
+  ffi_cif_info *info = ffi_cif_info_find (cif);
+
+  return info != NULL && cif_info_observed (info);
+}
+
+/* Whether any of the state in INFO needs the slow path.  */
+
+static int
+cif_info_active (const ffi_cif_info *info)
+{
+  return cif_info_observed (info) || info->plan != NULL;
+}
+
+static inline unsigned long long
+cif_info_clock (void)
+{
+#if defined (__x86_64__) || defined (__i386__)
+  return __builtin_ia32_rdtsc ();
+#else
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (unsigned long long) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+/* The hooks run outside of the time that is counted.  */
+
+unsigned long long
+ffi_cif_info_enter (ffi_cif *cif, int which, ffi_cif_info **infop)
+{
+  ffi_cif_info *info = ffi_cif_info_find (cif);
+  void (*hook) (ffi_cif *, void *);
+
+  /* A copy of a cif carries its flags, but not its entry.  */
+  *infop = info;
+  if (info == NULL)
+    return 0;
+
+  hook = (which == FFI_CIF_INFO_CALL
+	  ? info->hooks.before_call : info->hooks.before_closure);
+  if (hook)
+    hook (cif, info->hooks.data);
+  return info->counting ? cif_info_clock () : 0;
+}
+
+void
+ffi_cif_info_leave (ffi_cif_info *info, ffi_cif *cif, int which,
+		    unsigned long long start)
+{
+  void (*hook) (ffi_cif *, void *);
+
+  if (info == NULL)
+    return;
+
+  if (info->counting)
+    {
+      unsigned long long ticks = cif_info_clock () - start;
+
+      __atomic_fetch_add (which == FFI_CIF_INFO_CALL
+			  ? &info->calls : &info->closure_calls,
+			  1, __ATOMIC_RELAXED);
+      __atomic_fetch_add (&info->ticks, ticks, __ATOMIC_RELAXED);
+    }
+
+  hook = (which == FFI_CIF_INFO_CALL
+	  ? info->hooks.after_call : info->hooks.after_closure);
+  if (hook)
+    hook (cif, info->hooks.data);
+}
+
+ffi_status
+ffi_cif_set_hooks (ffi_cif *cif, const ffi_hooks *hooks)
+{
+  ffi_cif_info *info;
+
+  if (hooks == NULL)
+    {
+      info = ffi_cif_info_find (cif);
+      if (info == NULL)
+	return FFI_OK;
+      memset (&info->hooks, 0, sizeof (info->hooks));
+    }
+  else
+    {
+      info = cif_info_get (cif);
+      if (info == NULL)
+	return FFI_BAD_ABI;
+      info->hooks = *hooks;
+    }
+
+  return ffi_cif_info_machdep (cif, cif_info_active (info));
+}
+
+ffi_status
+ffi_cif_set_counting (ffi_cif *cif, int enable)
+{
+  ffi_cif_info *info;
+
+  if (enable)
+    {
+      info = cif_info_get (cif);
+      if (info == NULL)
+	return FFI_BAD_ABI;
+      info->counting = 1;
+    }
+  else
+    {
+      info = ffi_cif_info_find (cif);
+      if (info == NULL || info->counting == 0)
+	return FFI_OK;
+      info->counting = 0;
+    }
+
+  return ffi_cif_info_machdep (cif, cif_info_active (info));
+}
+
+/* Tiering.  Most cifs are called a few times, so they are not worth
+   the memory of a plan; the ones that are called often enough are
+   lowered into one, which later calls go through instead of
+   classifying the arguments again.  */
+
+unsigned ffi_tier_threshold;
+ffi_tier_slot ffi_tier_slots[FFI_TIER_SLOTS];
+
+void
+ffi_tier_up (ffi_cif *cif)
+{
+  ffi_cif_info *info;
+  ffi_plan *plan, *expected = NULL;
+
+  plan = ffi_plan_alloc (cif);
+  if (plan == NULL)
+    return;
+  if (!plan->lowered || (info = cif_info_get (cif)) == NULL)
+    {
+      ffi_plan_free (plan);
+      return;
+    }
+
+  /* Another thread may have got there first.  */
+  if (!__atomic_compare_exchange_n (&info->plan, &expected, plan, 0,
+				    __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    ffi_plan_free (plan);
+  __atomic_store_n (&ffi_tier_slot_of (cif)->info, info, __ATOMIC_RELEASE);
+  ffi_cif_info_machdep (cif, 1);
+}
+
+void
+ffi_set_tier_threshold (unsigned calls)
+{
+  __atomic_store_n (&ffi_tier_threshold, calls, __ATOMIC_RELAXED);
+}
+
+void
+ffi_cif_stats_foreach (void (*fn) (const ffi_cif_stats *, void *),
+		       void *data)
+{
+  ffi_cif_info *info;
+  ffi_cif_stats stats;
+  unsigned i;
+
+  for (i = 0; i < CIF_INFO_BUCKETS; i++)
+    for (info = __atomic_load_n (&cif_info_table[i], __ATOMIC_ACQUIRE);
+	 info != NULL; info = info->next)
+      {
+	stats.cif = __atomic_load_n (&info->cif, __ATOMIC_ACQUIRE);
+	if (stats.cif == NULL)
+	  continue;
+	stats.calls = __atomic_load_n (&info->calls, __ATOMIC_RELAXED);
+	stats.closure_calls = __atomic_load_n (&info->closure_calls,
+					       __ATOMIC_RELAXED);
+	stats.ticks = __atomic_load_n (&info->ticks, __ATOMIC_RELAXED);
+	if (info->counting || stats.calls || stats.closure_calls)
+	  fn (&stats, data);
+      }
+}
+
+#else
+
+ffi_status
+ffi_cif_set_hooks (ffi_cif *cif MAYBE_UNUSED,
+		   const ffi_hooks *hooks MAYBE_UNUSED)
+{
+  return FFI_BAD_ABI;
+}
+
+ffi_status
+ffi_cif_set_counting (ffi_cif *cif MAYBE_UNUSED, int enable MAYBE_UNUSED)
+{
+  return FFI_BAD_ABI;
+}
+
+void
+ffi_set_tier_threshold (unsigned calls MAYBE_UNUSED)
+{
+}
+
+void
+ffi_cif_release (ffi_cif *cif MAYBE_UNUSED)
+{
+}
+
+void
+ffi_cif_stats_foreach (void (*fn) (const ffi_cif_stats *,
+				   void *) MAYBE_UNUSED,
+		       void *data MAYBE_UNUSED)
+{
+}
+
+#endif
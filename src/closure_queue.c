@@ -0,0 +1,262 @@
+/* -----------------------------------------------------------------------
+   closure_queue.c - Copyright (c) 2026  libffi contributors
+
+   Closures whose calls from other threads are run by an owner thread.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include <ffi.h>
+#include <ffi_common.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if FFI_CLOSURES
+
+#if !defined(_WIN32) && defined(__GNUC__)
+
+#include <pthread.h>
+
+/* A call waiting for the owner thread.  A call that waits for its
+   result lives on the stack of the calling thread, and the arguments
+   stay in the closure's frame; a call that does not wait is allocated
+   with a copy of its arguments after it.  */
+typedef struct ffi_queued_call
+{
+  struct ffi_queued_call *next;
+  ffi_queued_closure *qc;
+  void *resp;
+  void **args;
+  int waiting, finished;
+} ffi_queued_call;
+
+/* Other threads push calls onto HEAD with a compare-and-swap, so they
+   never wait for each other or for the owner to queue a call.  The
+   owner takes the whole list at once and runs it oldest first.  */
+struct ffi_closure_queue
+{
+  ffi_queued_call *head;
+  pthread_t owner;
+  void (*notify) (ffi_closure_queue *, void *);
+  void *notify_data;
+  pthread_mutex_t lock;
+  pthread_cond_t finished;
+};
+
+ffi_closure_queue *
+ffi_closure_queue_alloc (void (*notify) (ffi_closure_queue *, void *),
+			 void *notify_data)
+{
+  ffi_closure_queue *queue = malloc (sizeof (ffi_closure_queue));
+
+  if (queue == NULL)
+    return NULL;
+  queue->head = NULL;
+  queue->owner = pthread_self ();
+  queue->notify = notify;
+  queue->notify_data = notify_data;
+  pthread_mutex_init (&queue->lock, NULL);
+  pthread_cond_init (&queue->finished, NULL);
+  return queue;
+}
+
+void
+ffi_closure_queue_free (ffi_closure_queue *queue)
+{
+  ffi_closure_queue_run (queue);
+  pthread_mutex_destroy (&queue->lock);
+  pthread_cond_destroy (&queue->finished);
+  free (queue);
+}
+
+unsigned
+ffi_closure_queue_run (ffi_closure_queue *queue)
+{
+  ffi_queued_call *call, *prev, *next;
+  unsigned count = 0;
+  ffi_arg void_resp;
+
+  FFI_ASSERT (pthread_equal (queue->owner, pthread_self ()));
+
+  call = __atomic_exchange_n (&queue->head, NULL, __ATOMIC_ACQUIRE);
+  for (prev = NULL; call != NULL; call = next)
+    {
+      next = call->next;
+      call->next = prev;
+      prev = call;
+    }
+
+  for (call = prev; call != NULL; call = next, count++)
+    {
+      ffi_queued_closure *qc = call->qc;
+
+      /* Once a waiting call is finished, its thread may return and
+	 reuse the stack it lives on.  */
+      next = call->next;
+      qc->fun (qc->closure.cif, call->resp ? call->resp : &void_resp,
+	       call->args, qc->user_data);
+      if (!call->waiting)
+	{
+	  free (call);
+	  continue;
+	}
+      pthread_mutex_lock (&queue->lock);
+      call->finished = 1;
+      pthread_cond_broadcast (&queue->finished);
+      pthread_mutex_unlock (&queue->lock);
+    }
+
+  return count;
+}
+
+static void
+ffi_closure_queue_push (ffi_closure_queue *queue, ffi_queued_call *call)
+{
+  ffi_queued_call *old = __atomic_load_n (&queue->head, __ATOMIC_RELAXED);
+
+  do
+    call->next = old;
+  while (!__atomic_compare_exchange_n (&queue->head, &old, call, 1,
+				       __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+  /* The owner takes the whole list, so only the first call after that
+     needs to wake it.  */
+  if (old == NULL && queue->notify)
+    queue->notify (queue, queue->notify_data);
+}
+
+static void
+ffi_queued_closure_dispatch (ffi_cif *cif, void *resp, void **args,
+			     void *user_data)
+{
+  ffi_queued_closure *qc = user_data;
+  ffi_closure_queue *queue = qc->queue;
+  ffi_queued_call *call, local;
+
+  if (pthread_equal (queue->owner, pthread_self ()))
+    {
+      qc->fun (cif, resp, args, qc->user_data);
+      return;
+    }
+
+  if (qc->flags & FFI_QUEUED_NOWAIT)
+    {
+      size_t align = 1, size, off;
+      char *block;
+      unsigned i;
+
+      for (i = 0; i < cif->nargs; i++)
+	if (cif->arg_types[i]->alignment > align)
+	  align = cif->arg_types[i]->alignment;
+      ffi_get_packed_offsets (cif, NULL, &size);
+
+      call = malloc (sizeof (ffi_queued_call) + cif->nargs * sizeof (void *)
+		     + align - 1 + size);
+      if (call == NULL)
+	abort ();
+      call->args = (void **) (call + 1);
+      block = (char *) FFI_ALIGN ((size_t) (call->args + cif->nargs), align);
+      for (i = 0, off = 0; i < cif->nargs; i++)
+	{
+	  ffi_type *type = cif->arg_types[i];
+
+	  off = FFI_ALIGN (off, type->alignment);
+	  call->args[i] = memcpy (block + off, args[i], type->size);
+	  off += type->size;
+	}
+      call->qc = qc;
+      call->resp = NULL;
+      call->waiting = 0;
+      ffi_closure_queue_push (queue, call);
+      return;
+    }
+
+  call = &local;
+  call->qc = qc;
+  call->resp = resp;
+  call->args = args;
+  call->waiting = 1;
+  call->finished = 0;
+  ffi_closure_queue_push (queue, call);
+
+  pthread_mutex_lock (&queue->lock);
+  while (!call->finished)
+    pthread_cond_wait (&queue->finished, &queue->lock);
+  pthread_mutex_unlock (&queue->lock);
+}
+
+ffi_status
+ffi_prep_queued_closure_loc (ffi_queued_closure *qc,
+			     ffi_cif *cif,
+			     void (*fun)(ffi_cif*,void*,void**,void*),
+			     void *user_data,
+			     ffi_closure_queue *queue,
+			     unsigned flags,
+			     void *codeloc)
+{
+  if ((flags & FFI_QUEUED_NOWAIT) && cif->rtype->type != FFI_TYPE_VOID)
+    return FFI_BAD_TYPEDEF;
+
+  qc->fun = fun;
+  qc->user_data = user_data;
+  qc->queue = queue;
+  qc->flags = flags;
+  return ffi_prep_closure_loc (&qc->closure, cif, ffi_queued_closure_dispatch,
+			       qc, codeloc);
+}
+
+#else
+
+ffi_closure_queue *
+ffi_closure_queue_alloc (void (*notify) (ffi_closure_queue *, void *)
+			 MAYBE_UNUSED,
+			 void *notify_data MAYBE_UNUSED)
+{
+  return NULL;
+}
+
+void
+ffi_closure_queue_free (ffi_closure_queue *queue MAYBE_UNUSED)
+{
+}
+
+unsigned
+ffi_closure_queue_run (ffi_closure_queue *queue MAYBE_UNUSED)
+{
+  return 0;
+}
+
+ffi_status
+ffi_prep_queued_closure_loc (ffi_queued_closure *qc MAYBE_UNUSED,
+			     ffi_cif *cif MAYBE_UNUSED,
+			     void (*fun)(ffi_cif*,void*,void**,void*)
+			     MAYBE_UNUSED,
+			     void *user_data MAYBE_UNUSED,
+			     ffi_closure_queue *queue MAYBE_UNUSED,
+			     unsigned flags MAYBE_UNUSED,
+			     void *codeloc MAYBE_UNUSED)
+{
+  return FFI_BAD_ABI;
+}
+
+#endif
+
+#endif /* FFI_CLOSURES */
@@ -874,6 +874,115 @@ allocate_space (int fd, off_t offset, off_t len)
   return 0;
 }
 
+#if defined (FFI_TARGET_HAS_EXEC_CFI) && defined (__linux__)
+
+/* Unwind info for the executable chunks, so that profilers and
+   debuggers can unwind from a sample taken in a trampoline.  Each chunk
+   gets one FDE covering all of it, built by ffi_exec_cfi_machdep; this
+   relies on trampolines leaving the stack as it was on entry.  The
+   frames are registered with libgcc's __register_frame, which takes a
+   whole .eh_frame section.  */
+
+extern void __register_frame (void *);
+extern void __deregister_frame (void *);
+
+struct exec_cfi
+{
+  struct exec_cfi *next;
+  char *code;
+  size_t length;
+  unsigned long long frame[FFI_EXEC_CFI_SIZE / sizeof (unsigned long long)];
+};
+
+static struct exec_cfi *exec_cfi_list;
+static pthread_mutex_t exec_cfi_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Register an FDE for LENGTH bytes at CODE and return its entry, not
+   yet on the list.  Without the unwind info, only unwinding from the
+   trampolines suffers, so running out of memory is not an error.  */
+
+static struct exec_cfi *
+exec_cfi_new (char *code, size_t length)
+{
+  struct exec_cfi *cfi = malloc (sizeof (*cfi));
+
+  if (cfi == NULL)
+    return NULL;
+
+  cfi->code = code;
+  cfi->length = length;
+  ffi_exec_cfi_machdep (cfi->frame, code, length);
+  __register_frame (cfi->frame);
+  return cfi;
+}
+
+static void
+exec_cfi_register (void *code, size_t length)
+{
+  struct exec_cfi *cfi = exec_cfi_new (code, length);
+
+  if (cfi == NULL)
+    return;
+
+  pthread_mutex_lock (&exec_cfi_mutex);
+  cfi->next = exec_cfi_list;
+  exec_cfi_list = cfi;
+  pthread_mutex_unlock (&exec_cfi_mutex);
+}
+
+/* dlmalloc may unmap only part of a chunk, as when it trims the end of
+   a segment.  An FDE must not keep covering the pages that are gone,
+   since libgcc searches registered frames before the loaded objects,
+   and code mapped there later would be unwound with the trampolines'
+   CFI.  So the FDE of an entry that overlaps the unmapped range is
+   replaced with FDEs for what is left of it on either side.  */
+
+static void
+exec_cfi_deregister (void *code, size_t length)
+{
+  char *lo = code, *hi = lo + length;
+  struct exec_cfi **p, *cfi, *left, *right;
+
+  pthread_mutex_lock (&exec_cfi_mutex);
+  for (p = &exec_cfi_list; (cfi = *p) != NULL; )
+    if (cfi->code < hi && cfi->code + cfi->length > lo)
+      {
+	*p = cfi->next;
+	__deregister_frame (cfi->frame);
+
+	left = right = NULL;
+	if (cfi->code < lo)
+	  left = exec_cfi_new (cfi->code, lo - cfi->code);
+	if (cfi->code + cfi->length > hi)
+	  right = exec_cfi_new (hi, cfi->code + cfi->length - hi);
+	free (cfi);
+
+	/* The pieces go in front of P, so they are not visited again.  */
+	if (left != NULL)
+	  {
+	    left->next = *p;
+	    *p = left;
+	    p = &left->next;
+	  }
+	if (right != NULL)
+	  {
+	    right->next = *p;
+	    *p = right;
+	    p = &right->next;
+	  }
+      }
+    else
+      p = &cfi->next;
+  pthread_mutex_unlock (&exec_cfi_mutex);
+}
+
+#else
+
+#define exec_cfi_register(code, length)
+#define exec_cfi_deregister(code, length)
+
+#endif
+
 /* Map in a chunk of memory from the temporary exec file into separate
    locations in the virtual memory address space, one writable and one
    executable.  Returns the address of the writable portion, after
@@ -940,6 +1049,8 @@ dlmmap_locked (void *start, size_t length, int prot, int flags, off_t offset)
   mmap_exec_offset ((char *)start, length) = (char*)ptr - (char*)start;
 
   execsize += length;
+  FFI_PROBE3 (exec__grow, ptr, start, length);
+  exec_cfi_register (ptr, length);
 
   mem_callbacks.on_allocate (ptr, length);
   mem_callbacks.on_allocate (start, length);
@@ -972,7 +1083,11 @@ dlmmap (void *start, size_t length, int prot,
     {
       ptr = mmap (start, length, prot | PROT_EXEC, flags, fd, offset);
       if (ptr != MFAIL)
-        mem_callbacks.on_allocate (ptr, length);
+	{
+	  mem_callbacks.on_allocate (ptr, length);
+	  FFI_PROBE3 (exec__grow, ptr, ptr, length);
+	  exec_cfi_register (ptr, length);
+	}
 
       if (ptr != MFAIL || (errno != EPERM && errno != EACCES))
 	/* Cool, no need to mess with separate segments.  */
@@ -1016,12 +1131,18 @@ dlmunmap (void *start, size_t length)
       if (ret)
 	return ret;
       else
-        mem_callbacks.on_deallocate (code, length);
+	{
+	  mem_callbacks.on_deallocate (code, length);
+	  exec_cfi_deregister (code, length);
+	}
     }
 
   ret = munmap (start, length);
   if (ret == 0)
-    mem_callbacks.on_deallocate (start, length);
+    {
+      mem_callbacks.on_deallocate (start, length);
+      exec_cfi_deregister (start, length);
+    }
   return ret;
 }
 
@@ -0,0 +1,87 @@
+/* -----------------------------------------------------------------------
+   packed.c - Copyright (c) 2026  libffi contributors
+
+   Calls with the arguments packed into one contiguous block.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include <ffi.h>
+#include <ffi_common.h>
+#include <stdlib.h>
+
+/* The packed block of a cif holds its arguments laid out like the
+   members of a structure: each at the next offset that is a multiple
+   of its alignment, with the whole block padded to the largest
+   alignment.  The argument types were laid out by ffi_prep_cif, so
+   this is only a little arithmetic per argument.  */
+
+ffi_status
+ffi_get_packed_offsets (ffi_cif *cif, size_t *offsets, size_t *size)
+{
+  size_t off = 0;
+  unsigned short align = 1;
+  unsigned i;
+
+  for (i = 0; i < cif->nargs; i++)
+    {
+      ffi_type *type = cif->arg_types[i];
+
+      FFI_ASSERT_VALID_TYPE (type);
+      off = FFI_ALIGN (off, type->alignment);
+      if (offsets)
+	offsets[i] = off;
+      off += type->size;
+      if (type->alignment > align)
+	align = type->alignment;
+    }
+
+  if (size)
+    *size = FFI_ALIGN (off, align);
+  return FFI_OK;
+}
+
+#ifndef FFI_TARGET_HAS_CALL_PACKED
+/* Call FN with the arguments in the packed block ARGS.  Targets that
+   can marshal straight from the block implement this themselves; here
+   the pointer array ffi_call wants is built on the stack and points
+   into ARGS.  */
+
+void
+ffi_call_packed (ffi_cif *cif, void (*fn)(void), void *rvalue,
+		 const void *args)
+{
+  void **avalue = alloca (cif->nargs * sizeof (void *));
+  size_t off = 0;
+  unsigned i;
+
+  for (i = 0; i < cif->nargs; i++)
+    {
+      ffi_type *type = cif->arg_types[i];
+
+      off = FFI_ALIGN (off, type->alignment);
+      avalue[i] = (char *) args + off;
+      off += type->size;
+    }
+
+  ffi_call (cif, fn, rvalue, avalue);
+}
+#endif
@@ -0,0 +1,138 @@
+/* -----------------------------------------------------------------------
+   perfmap.c - Copyright (c) 2026  libffi contributors
+
+   Symbols for closure trampolines in perf map files.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include <ffi.h>
+#include <ffi_common.h>
+#include <stdint.h>
+
+#if FFI_CLOSURES && defined (__linux__)
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* perf looks up symbols for code outside of any mapped file in
+   /tmp/perf-<pid>.map, one "START SIZE NAME" line per symbol.  The file
+   is only written when LIBFFI_PERF_MAP is set in the environment, and
+   is opened the first time a closure is prepared.  The format has no
+   way to remove a symbol; perf takes the latest line for an address, so
+   a trampoline that is reused gets the name of its new closure.
+
+   The name is easy to guess and /tmp is shared, so the file is not
+   followed if it is a symbolic link, and is only written if it is a
+   regular file that belongs to this process's user.
+
+   A child of fork inherits the descriptor of its parent's file, so the
+   pid the file was opened for is kept with it, and a process that finds
+   another pid there opens its own file.  The pid is stored after the
+   descriptor and loaded before it.  */
+
+static int perf_map_fd = -2;
+static pid_t perf_map_pid;
+static pthread_mutex_t perf_map_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int
+perf_map_open (void)
+{
+  int fd = __atomic_load_n (&perf_map_fd, __ATOMIC_RELAXED);
+  pid_t pid;
+  char name[32];
+  const char *env;
+  struct stat st;
+
+  /* Disabled, and so for the children too.  */
+  if (fd == -1)
+    return fd;
+
+  pid = getpid ();
+  if (__atomic_load_n (&perf_map_pid, __ATOMIC_ACQUIRE) == pid)
+    return __atomic_load_n (&perf_map_fd, __ATOMIC_RELAXED);
+
+  pthread_mutex_lock (&perf_map_lock);
+  fd = perf_map_fd;
+  if (perf_map_pid != pid)
+    {
+      /* The parent's file, if any, is not ours to write.  */
+      if (fd >= 0)
+	close (fd);
+      env = getenv ("LIBFFI_PERF_MAP");
+      fd = -1;
+      if (env != NULL && *env != '\0' && *env != '0')
+	{
+	  snprintf (name, sizeof (name), "/tmp/perf-%d.map", (int) pid);
+	  fd = open (name, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC
+			   | O_NOFOLLOW, 0644);
+	  if (fd >= 0
+	      && (fstat (fd, &st) != 0 || !S_ISREG (st.st_mode)
+		  || st.st_uid != geteuid ()))
+	    {
+	      close (fd);
+	      fd = -1;
+	    }
+	}
+      __atomic_store_n (&perf_map_fd, fd, __ATOMIC_RELAXED);
+      __atomic_store_n (&perf_map_pid, pid, __ATOMIC_RELEASE);
+    }
+  pthread_mutex_unlock (&perf_map_lock);
+  return fd;
+}
+
+void
+ffi_perf_map_closure (void *code, size_t size, const ffi_cif *cif,
+		      void *fun)
+{
+  char line[128];
+  int fd = perf_map_open (), len;
+
+  if (fd < 0)
+    return;
+
+  /* A single write with O_APPEND keeps lines from several threads, or
+     from other writers of the file, whole.  */
+  len = snprintf (line, sizeof (line),
+		  "%lx %lx ffi_closure[fun=%p cif=%p nargs=%u]\n",
+		  (unsigned long) (uintptr_t) code, (unsigned long) size,
+		  fun, (void *) cif, cif->nargs);
+  if (len > 0 && len < (int) sizeof (line)
+      && write (fd, line, len) != len)
+    {
+      /* Nothing can be done about it here.  */
+    }
+}
+
+#else
+
+void
+ffi_perf_map_closure (void *code MAYBE_UNUSED, size_t size MAYBE_UNUSED,
+		      const ffi_cif *cif MAYBE_UNUSED,
+		      void *fun MAYBE_UNUSED)
+{
+}
+
+#endif
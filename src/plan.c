@@ -0,0 +1,226 @@
+/* -----------------------------------------------------------------------
+   plan.c - Copyright (c) 2026  libffi contributors
+
+   Architecture-neutral call plans.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include <ffi.h>
+#include <ffi_common.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+static void run_steps (const ffi_plan_step *step, const ffi_plan_step *end,
+		       char *image, void *rvalue, void **avalue);
+
+/* Allocate a plan for CIF, which must already have been prepared with
+   ffi_prep_cif or ffi_prep_cif_var.  If the target cannot lower the
+   cif, the plan is still usable; ffi_call_plan then defers to
+   ffi_call.  */
+
+ffi_plan *
+ffi_plan_alloc (ffi_cif *cif)
+{
+  ffi_plan *plan;
+
+  plan = malloc (sizeof (ffi_plan)
+		 + FFI_PLAN_MAX_STEPS (cif->nargs) * sizeof (ffi_plan_step));
+  if (plan == NULL)
+    return NULL;
+
+  plan->cif = cif;
+  plan->lowered = 0;
+  plan->flags = cif->flags;
+  plan->image_size = 0;
+  plan->rsize = 0;
+  plan->bound = NULL;
+  plan->image_init = NULL;
+  plan->nsteps = 0;
+
+#ifdef FFI_TARGET_HAS_PLAN
+  if (ffi_prep_plan_machdep (plan) == FFI_OK)
+    {
+      FFI_ASSERT (plan->nsteps <= FFI_PLAN_MAX_STEPS (cif->nargs));
+      plan->lowered = 1;
+    }
+  else
+    plan->nsteps = 0;
+#endif
+
+  return plan;
+}
+
+/* Allocate a plan for CIF in which argument I is bound to the value
+   BOUND[I] points to, for each I where BOUND[I] is not NULL.  The
+   values are copied.  When the plan is lowered, the bound arguments
+   and any constants are written into an initial call image once, and
+   their steps are dropped, so that each call only copies that image
+   and moves the arguments that vary.  */
+
+ffi_plan *
+ffi_plan_alloc_bound (ffi_cif *cif, void **bound)
+{
+  ffi_plan *plan;
+  size_t size;
+  char *values;
+  unsigned i, n;
+
+  plan = ffi_plan_alloc (cif);
+  if (plan == NULL)
+    return NULL;
+
+  /* Each value is 16-byte aligned; malloc may only align the block to
+     8 bytes, so allow for aligning the first one.  */
+  size = cif->nargs * sizeof (void *) + 15;
+  for (i = 0; i < cif->nargs; i++)
+    if (bound[i])
+      size += FFI_ALIGN (cif->arg_types[i]->size, 16);
+
+  plan->bound = malloc (size);
+  if (plan->bound == NULL)
+    {
+      ffi_plan_free (plan);
+      return NULL;
+    }
+  values = (char *) (plan->bound + cif->nargs);
+  for (i = 0; i < cif->nargs; i++)
+    if (bound[i])
+      {
+	values = (char *) FFI_ALIGN (values, 16);
+	memcpy (values, bound[i], cif->arg_types[i]->size);
+	plan->bound[i] = values;
+	values += cif->arg_types[i]->size;
+      }
+    else
+      plan->bound[i] = NULL;
+
+  if (!plan->lowered)
+    return plan;
+
+  plan->image_init = calloc (1, plan->image_size);
+  if (plan->image_init == NULL)
+    {
+      ffi_plan_free (plan);
+      return NULL;
+    }
+
+  /* Run the steps that do not vary between calls into the initial
+     image, and keep the others.  */
+  for (i = n = 0; i < plan->nsteps; i++)
+    {
+      ffi_plan_step *step = &plan->steps[i];
+
+      if (step->op == FFI_PLAN_CONST
+	  || (step->op != FFI_PLAN_RVALUE && plan->bound[step->arg]))
+	run_steps (step, step + 1, plan->image_init, NULL, plan->bound);
+      else
+	plan->steps[n++] = *step;
+    }
+  plan->nsteps = n;
+
+  return plan;
+}
+
+void
+ffi_plan_free (ffi_plan *plan)
+{
+  free (plan->image_init);
+  free (plan->bound);
+  free (plan);
+}
+
+/* The plan interpreter.  Each step reads from one argument and writes
+   one location of the call image; nothing here depends on the
+   target.  */
+
+static void
+run_steps (const ffi_plan_step *step, const ffi_plan_step *end, char *image,
+	   void *rvalue, void **avalue)
+{
+  ffi_arg slot;
+
+  for (; step < end; step++)
+    {
+      char *dst = image + step->dst;
+
+#define SRC(T)	((T *) ((char *) avalue[step->arg] + step->src))
+      switch (step->op)
+	{
+	case FFI_PLAN_COPY:
+	  memcpy (dst, SRC (char), step->size);
+	  continue;
+	case FFI_PLAN_SLOT:
+	  slot = 0;
+	  memcpy (&slot, SRC (char), step->size);
+	  break;
+	case FFI_PLAN_SINT8:
+	  slot = (ffi_sarg) *SRC (SINT8);
+	  break;
+	case FFI_PLAN_SINT16:
+	  slot = (ffi_sarg) *SRC (SINT16);
+	  break;
+	case FFI_PLAN_SINT32:
+	  slot = (ffi_sarg) *SRC (SINT32);
+	  break;
+	case FFI_PLAN_RVALUE:
+	  slot = (ffi_arg) (uintptr_t) rvalue;
+	  break;
+	case FFI_PLAN_CONST:
+	  slot = step->src;
+	  break;
+	default:
+	  abort ();
+	}
+#undef SRC
+      memcpy (dst, &slot, sizeof (slot));
+    }
+}
+
+void FFI_HIDDEN
+ffi_plan_run (const ffi_plan *plan, char *image, void *rvalue,
+	      void **avalue)
+{
+  run_steps (plan->steps, plan->steps + plan->nsteps, image, rvalue, avalue);
+}
+
+void
+ffi_call_plan (ffi_plan *plan, void (*fn)(void), void *rvalue,
+	       void **avalue)
+{
+#ifdef FFI_TARGET_HAS_PLAN
+  if (plan->lowered)
+    {
+      ffi_call_plan_machdep (plan, fn, rvalue, avalue);
+      return;
+    }
+#endif
+  if (plan->bound)
+    {
+      void **merged = alloca (plan->cif->nargs * sizeof (void *));
+      unsigned i;
+
+      for (i = 0; i < plan->cif->nargs; i++)
+	merged[i] = plan->bound[i] ? plan->bound[i] : avalue[i];
+      avalue = merged;
+    }
+  ffi_call (plan->cif, fn, rvalue, avalue);
+}
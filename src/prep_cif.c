@@ -26,6 +26,7 @@
 #include <ffi.h>
 #include <ffi_common.h>
 #include <stdlib.h>
+#include <errno.h>
 
 /* Round up to FFI_SIZEOF_ARG. */
 
@@ -129,6 +130,9 @@ ffi_status FFI_HIDDEN ffi_prep_cif_core(ffi_cif *cif, ffi_abi abi,
   cif->rtype = rtype;
 
   cif->flags = 0;
+#ifdef FFI_TARGET_HAS_CIF_INFO
+  ffi_cif_info_reset (cif);
+#endif
 #if (defined(_M_ARM64) || defined(__aarch64__)) && defined(_WIN32)
   cif->is_variadic = isvariadic;
 #endif
@@ -207,6 +211,7 @@ ffi_status FFI_HIDDEN ffi_prep_cif_core(ffi_cif *cif, ffi_abi abi,
     }
 
   cif->bytes = bytes;
+  FFI_PROBE3 (prep__cif, cif, abi, ntotalargs);
 
   /* Perform machine dependent cif processing */
 #ifdef FFI_TARGET_SPECIFIC_VARIADIC
@@ -234,6 +239,126 @@ ffi_status ffi_prep_cif_var(ffi_cif *cif,
   return ffi_prep_cif_core(cif, abi, 1, nfixedargs, ntotalargs, rtype, atypes);
 }
 
+/* Prepare the fixed part of a variadic signature once.  Where the
+   target supports it, ffi_prep_cif_var_tail then starts from the
+   state after the fixed arguments instead of examining them all over
+   again for each call.  */
+
+ffi_status ffi_prep_var_cif(ffi_var_cif *vcif,
+			    ffi_abi abi,
+			    unsigned int nfixedargs,
+			    ffi_type *rtype,
+			    ffi_type **atypes)
+{
+  ffi_status status;
+
+  status = ffi_prep_cif_var(&vcif->fixed, abi, nfixedargs, nfixedargs,
+			    rtype, atypes);
+#ifdef FFI_TARGET_HAS_VAR_TAIL
+  if (status == FFI_OK)
+    ffi_prep_var_cif_machdep(vcif);
+#endif
+  return status;
+}
+
+ffi_status ffi_prep_cif_var_tail(ffi_cif *cif,
+				 const ffi_var_cif *vcif,
+				 unsigned int ntotalargs,
+				 ffi_type **atypes)
+{
+  const ffi_cif *fixed = &vcif->fixed;
+
+  FFI_ASSERT(ntotalargs >= fixed->nargs);
+
+#ifdef FFI_TARGET_HAS_VAR_TAIL
+  {
+    ffi_type **ptr;
+    unsigned int i;
+
+    *cif = *fixed;
+    cif->arg_types = atypes;
+    cif->nargs = ntotalargs;
+#ifdef FFI_TARGET_HAS_CIF_INFO
+    /* The side-table state of the fixed cif is not the new cif's.  */
+    ffi_cif_info_reset (cif);
+    ffi_cif_info_machdep (cif, 0);
+#endif
+
+    for (ptr = atypes + fixed->nargs, i = fixed->nargs; i < ntotalargs;
+	 i++, ptr++)
+      {
+	/* Initialize any uninitialized aggregate type definitions */
+	if (((*ptr)->size == 0)
+	    && (initialize_aggregate((*ptr), NULL) != FFI_OK))
+	  return FFI_BAD_TYPEDEF;
+
+#ifndef FFI_TARGET_HAS_COMPLEX_TYPE
+	if ((*ptr)->type == FFI_TYPE_COMPLEX)
+	  abort();
+#endif
+	FFI_ASSERT_VALID_TYPE(*ptr);
+      }
+
+    if (ffi_prep_cif_var_tail_machdep(cif, vcif) == FFI_OK)
+      {
+	FFI_PROBE3 (prep__cif, cif, fixed->abi, ntotalargs);
+	return FFI_OK;
+      }
+  }
+#endif
+
+  return ffi_prep_cif_var(cif, fixed->abi, fixed->nargs, ntotalargs,
+			  fixed->rtype, atypes);
+}
+
+#ifndef FFI_TARGET_HAS_CALL_IMAGE
+ffi_status
+ffi_get_image_layout (ffi_cif *cif MAYBE_UNUSED,
+		      ffi_image_layout *layout MAYBE_UNUSED,
+		      size_t *offsets MAYBE_UNUSED)
+{
+  return FFI_BAD_ABI;
+}
+
+void
+ffi_call_image (ffi_cif *cif MAYBE_UNUSED,
+		void (*fn)(void) MAYBE_UNUSED,
+		void *rvalue MAYBE_UNUSED,
+		const void *image MAYBE_UNUSED)
+{
+  /* ffi_get_image_layout never succeeds, so there is no valid image
+     to call with.  */
+  abort ();
+}
+#endif
+
+#ifndef FFI_TARGET_HAS_CALL_ERRNO
+void
+ffi_call_errno (ffi_cif *cif, void (*fn)(void), void *rvalue,
+		void **avalue, int *errnop)
+{
+  int saved_errno = errno;
+
+  errno = *errnop;
+  ffi_call (cif, fn, rvalue, avalue);
+  *errnop = errno;
+  errno = saved_errno;
+}
+#endif
+
+#ifndef FFI_TARGET_HAS_CALL_ON_STACK
+ffi_status
+ffi_call_on_stack (ffi_cif *cif MAYBE_UNUSED,
+		   void (*fn)(void) MAYBE_UNUSED,
+		   void *rvalue MAYBE_UNUSED,
+		   void **avalue MAYBE_UNUSED,
+		   void *stack_base MAYBE_UNUSED,
+		   size_t stack_size MAYBE_UNUSED)
+{
+  return FFI_BAD_ABI;
+}
+#endif
+
 #if FFI_CLOSURES
 
 ffi_status
@@ -245,6 +370,30 @@ ffi_prep_closure (ffi_closure* closure,
   return ffi_prep_closure_loc (closure, cif, fun, user_data, closure);
 }
 
+#ifndef FFI_TARGET_HAS_TYPED_CLOSURE
+ffi_status
+ffi_prep_typed_closure_loc (ffi_closure* closure MAYBE_UNUSED,
+			    ffi_cif* cif MAYBE_UNUSED,
+			    void (*fun)(void) MAYBE_UNUSED,
+			    void *user_data MAYBE_UNUSED,
+			    void *codeloc MAYBE_UNUSED)
+{
+  return FFI_BAD_ABI;
+}
+#endif
+
+#ifndef FFI_TARGET_HAS_PACKED_CLOSURE
+ffi_status
+ffi_prep_packed_closure_loc (ffi_closure* closure MAYBE_UNUSED,
+			     ffi_cif* cif MAYBE_UNUSED,
+			     void (*fun)(ffi_cif*,void*,void*,void*) MAYBE_UNUSED,
+			     void *user_data MAYBE_UNUSED,
+			     void *codeloc MAYBE_UNUSED)
+{
+  return FFI_BAD_ABI;
+}
+#endif
+
 #endif
 
 ffi_status
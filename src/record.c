@@ -0,0 +1,236 @@
+/* -----------------------------------------------------------------------
+   record.c - Copyright (c) 2026  libffi contributors
+
+   Recording of the calls and closure invocations of a process.
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   ``Software''), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED ``AS IS'', WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   ----------------------------------------------------------------------- */
+
+#include <ffi.h>
+#include <ffi_common.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef FFI_TARGET_HAS_RECORD
+
+#include <pthread.h>
+
+/* The trace starts with FFI_RECORD_MAGIC, followed by records in host
+   byte order:
+
+     'S' u32 id, u8 abi, u16 nargs, type rtype, type args[nargs]
+	 Defines signature ID.  A type is its u8 type code, followed for
+	 a struct by a u16 element count and the element types, and for
+	 a complex type by the type of its parts.
+     'C' u32 id
+	 A call through signature ID.
+     'K' u32 id
+	 An invocation of a closure of signature ID.
+
+   A signature is defined before its first use.  Argument values are
+   not recorded.  */
+
+int ffi_record_active;
+
+static FILE *record_file;
+static pthread_mutex_t record_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned record_next_id;
+
+/* The ids of the cifs seen so far, by address.  The fields of the cif
+   that make its signature are kept, so that a cif prepared again for
+   another signature gets a new id.  */
+#define RECORD_BUCKETS 1024
+
+typedef struct record_sig
+{
+  struct record_sig *next;
+  const ffi_cif *cif;
+  ffi_abi abi;
+  unsigned nargs;
+  ffi_type *rtype;
+  ffi_type **arg_types;
+  unsigned id;
+} record_sig;
+
+static record_sig *record_table[RECORD_BUCKETS];
+
+static void
+record_u16 (unsigned v)
+{
+  uint16_t x = v;
+
+  fwrite (&x, sizeof (x), 1, record_file);
+}
+
+static void
+record_u32 (unsigned v)
+{
+  uint32_t x = v;
+
+  fwrite (&x, sizeof (x), 1, record_file);
+}
+
+static void
+record_type (const ffi_type *t)
+{
+  unsigned n;
+
+  putc (t->type, record_file);
+  switch (t->type)
+    {
+    case FFI_TYPE_STRUCT:
+      for (n = 0; t->elements[n] != NULL; n++)
+	;
+      record_u16 (n);
+      for (n = 0; t->elements[n] != NULL; n++)
+	record_type (t->elements[n]);
+      break;
+    case FFI_TYPE_COMPLEX:
+      record_type (t->elements[0]);
+      break;
+    }
+}
+
+static unsigned
+record_sig_id (const ffi_cif *cif)
+{
+  uintptr_t h = (uintptr_t) cif >> 4;
+  record_sig **bucket = &record_table[(h ^ (h >> 10)) % RECORD_BUCKETS];
+  record_sig *sig;
+  unsigned i;
+
+  for (sig = *bucket; sig != NULL; sig = sig->next)
+    if (sig->cif == cif)
+      break;
+
+  if (sig != NULL && sig->abi == cif->abi && sig->nargs == cif->nargs
+      && sig->rtype == cif->rtype && sig->arg_types == cif->arg_types)
+    return sig->id;
+
+  if (sig == NULL)
+    {
+      sig = malloc (sizeof (*sig));
+      if (sig == NULL)
+	return (unsigned) -1;
+      sig->cif = cif;
+      sig->next = *bucket;
+      *bucket = sig;
+    }
+  sig->abi = cif->abi;
+  sig->nargs = cif->nargs;
+  sig->rtype = cif->rtype;
+  sig->arg_types = cif->arg_types;
+  sig->id = record_next_id++;
+
+  putc ('S', record_file);
+  record_u32 (sig->id);
+  putc (cif->abi, record_file);
+  record_u16 (cif->nargs);
+  record_type (cif->rtype);
+  for (i = 0; i < cif->nargs; i++)
+    record_type (cif->arg_types[i]);
+  return sig->id;
+}
+
+void
+ffi_record_event (const ffi_cif *cif, int closure)
+{
+  unsigned id;
+
+  pthread_mutex_lock (&record_lock);
+  if (record_file != NULL)
+    {
+      id = record_sig_id (cif);
+      if (id != (unsigned) -1)
+	{
+	  putc (closure ? 'K' : 'C', record_file);
+	  record_u32 (id);
+	}
+    }
+  pthread_mutex_unlock (&record_lock);
+}
+
+static void
+record_close (void)
+{
+  record_sig *sig, *next;
+  unsigned i;
+
+  __atomic_store_n (&ffi_record_active, 0, __ATOMIC_RELAXED);
+  if (record_file != NULL)
+    {
+      fclose (record_file);
+      record_file = NULL;
+    }
+  for (i = 0; i < RECORD_BUCKETS; i++)
+    {
+      for (sig = record_table[i]; sig != NULL; sig = next)
+	{
+	  next = sig->next;
+	  free (sig);
+	}
+      record_table[i] = NULL;
+    }
+  record_next_id = 0;
+}
+
+ffi_status
+ffi_record_start (const char *path)
+{
+  ffi_status status = FFI_OK;
+
+  pthread_mutex_lock (&record_lock);
+  record_close ();
+  record_file = fopen (path, "wb");
+  if (record_file == NULL)
+    status = FFI_BAD_ABI;
+  else
+    {
+      fwrite (FFI_RECORD_MAGIC, sizeof (FFI_RECORD_MAGIC), 1, record_file);
+      __atomic_store_n (&ffi_record_active, 1, __ATOMIC_RELAXED);
+    }
+  pthread_mutex_unlock (&record_lock);
+  return status;
+}
+
+void
+ffi_record_stop (void)
+{
+  pthread_mutex_lock (&record_lock);
+  record_close ();
+  pthread_mutex_unlock (&record_lock);
+}
+
+#else
+
+ffi_status
+ffi_record_start (const char *path MAYBE_UNUSED)
+{
+  return FFI_BAD_ABI;
+}
+
+void
+ffi_record_stop (void)
+{
+}
+
+#endif
@@ -32,6 +32,7 @@
 
 #include <stdlib.h>
 #include <stdarg.h>
+#include <errno.h>
 #include <stdint.h>
 #include "internal64.h"
 
@@ -70,6 +71,9 @@ struct register_args
 
 extern void ffi_call_unix64 (void *args, unsigned long bytes, unsigned flags,
 			     void *raddr, void (*fnaddr)(void)) FFI_HIDDEN;
+extern void ffi_call_unix64_on_stack (void *args, unsigned long bytes,
+				      unsigned flags, void *raddr,
+				      void (*fnaddr)(void)) FFI_HIDDEN;
 
 /* All reference to register classes here is identical to the code in
    gcc/config/i386/i386.c. Do *not* change one without the other.  */
@@ -389,15 +393,130 @@ examine_argument (ffi_type *type, enum x86_64_reg_class classes[MAX_CLASSES],
 
 /* Perform machine dependent cif processing.  */
 
+/* Register-shape calls.  A signature whose arguments are all integers,
+   pointers, floats or doubles that fit in registers, and whose return
+   value is one of those or void, is called through a C routine compiled
+   for its shape instead of through ffi_call_unix64.  The shape is the
+   number of integer arguments and the number of SSE arguments, rounded
+   up to 0, 2, 4 or 8; the SSE registers beyond the arguments are passed
+   as zero.  This needs no code generation at run time.  */
+
+#define SHAPE_SSE_CLASSES 4
+#define SHAPE_COUNT ((MAX_GPR_REGS + 1) * SHAPE_SSE_CLASSES)
+
+static const unsigned char shape_sse_regs[SHAPE_SSE_CLASSES] = { 0, 2, 4, 8 };
+
+/* Return the UNIX64_FLAG_REG_SHAPE bits for CIF, whose return flags are
+   FLAGS, or 0 if it has no register shape.  */
+
+static unsigned
+reg_shape_flags (ffi_cif *cif, unsigned flags)
+{
+  unsigned i, ngpr = 0, nsse = 0, sse_class;
+
+  if (flags & UNIX64_FLAG_RET_IN_MEM)
+    return 0;
+
+  switch (cif->rtype->type)
+    {
+    case FFI_TYPE_VOID:
+    case FFI_TYPE_INT:
+    case FFI_TYPE_UINT8:
+    case FFI_TYPE_SINT8:
+    case FFI_TYPE_UINT16:
+    case FFI_TYPE_SINT16:
+    case FFI_TYPE_UINT32:
+    case FFI_TYPE_SINT32:
+    case FFI_TYPE_UINT64:
+    case FFI_TYPE_SINT64:
+    case FFI_TYPE_POINTER:
+    case FFI_TYPE_FLOAT:
+    case FFI_TYPE_DOUBLE:
+      break;
+    default:
+      return 0;
+    }
+
+  for (i = 0; i < cif->nargs; i++)
+    switch (cif->arg_types[i]->type)
+      {
+      case FFI_TYPE_INT:
+      case FFI_TYPE_UINT8:
+      case FFI_TYPE_SINT8:
+      case FFI_TYPE_UINT16:
+      case FFI_TYPE_SINT16:
+      case FFI_TYPE_UINT32:
+      case FFI_TYPE_SINT32:
+      case FFI_TYPE_UINT64:
+      case FFI_TYPE_SINT64:
+      case FFI_TYPE_POINTER:
+	ngpr++;
+	break;
+      case FFI_TYPE_FLOAT:
+      case FFI_TYPE_DOUBLE:
+	nsse++;
+	break;
+      default:
+	return 0;
+      }
+
+  if (ngpr > MAX_GPR_REGS || nsse > MAX_SSE_REGS)
+    return 0;
+
+  for (sse_class = 0; shape_sse_regs[sse_class] < nsse; sse_class++)
+    ;
+  return UNIX64_FLAG_REG_SHAPE
+	 | ((ngpr * SHAPE_SSE_CLASSES + sse_class) << UNIX64_SIZE_SHIFT);
+}
+
 #ifndef __ILP32__
 extern ffi_status
 ffi_prep_cif_machdep_efi64(ffi_cif *cif);
 #endif
 
+/* Go over arguments FIRST and up of CIF and determine the way they
+   should be passed.  If it's in a register and there is space for it,
+   let that be so.  If not, add its size to the stack byte count.  */
+
+static void
+count_args (ffi_cif *cif, unsigned first, int *pgprcount, int *pssecount,
+	    size_t *pbytes)
+{
+  enum x86_64_reg_class classes[MAX_CLASSES];
+  int gprcount = *pgprcount, ssecount = *pssecount, ngpr, nsse;
+  size_t bytes = *pbytes;
+  unsigned i;
+
+  for (i = first; i < cif->nargs; i++)
+    {
+      if (examine_argument (cif->arg_types[i], classes, 0, &ngpr, &nsse) == 0
+	  || gprcount + ngpr > MAX_GPR_REGS
+	  || ssecount + nsse > MAX_SSE_REGS)
+	{
+	  long align = cif->arg_types[i]->alignment;
+
+	  if (align < 8)
+	    align = 8;
+
+	  bytes = FFI_ALIGN (bytes, align);
+	  bytes += cif->arg_types[i]->size;
+	}
+      else
+	{
+	  gprcount += ngpr;
+	  ssecount += nsse;
+	}
+    }
+
+  *pgprcount = gprcount;
+  *pssecount = ssecount;
+  *pbytes = bytes;
+}
+
 ffi_status FFI_HIDDEN
 ffi_prep_cif_machdep (ffi_cif *cif)
 {
-  int gprcount, ssecount, i, avn, ngpr, nsse;
+  int gprcount, ssecount, ngpr, nsse;
   unsigned flags;
   enum x86_64_reg_class classes[MAX_CLASSES];
   size_t bytes, n, rtype_size;
@@ -522,31 +641,11 @@ ffi_prep_cif_machdep (ffi_cif *cif)
       return FFI_BAD_TYPEDEF;
     }
 
-  /* Go over all arguments and determine the way they should be passed.
-     If it's in a register and there is space for it, let that be so. If
-     not, add it's size to the stack byte count.  */
-  for (bytes = 0, i = 0, avn = cif->nargs; i < avn; i++)
-    {
-      if (examine_argument (cif->arg_types[i], classes, 0, &ngpr, &nsse) == 0
-	  || gprcount + ngpr > MAX_GPR_REGS
-	  || ssecount + nsse > MAX_SSE_REGS)
-	{
-	  long align = cif->arg_types[i]->alignment;
-
-	  if (align < 8)
-	    align = 8;
-
-	  bytes = FFI_ALIGN (bytes, align);
-	  bytes += cif->arg_types[i]->size;
-	}
-      else
-	{
-	  gprcount += ngpr;
-	  ssecount += nsse;
-	}
-    }
+  bytes = 0;
+  count_args (cif, 0, &gprcount, &ssecount, &bytes);
   if (ssecount)
     flags |= UNIX64_FLAG_XMM_ARGS;
+  flags |= reg_shape_flags (cif, flags);
 
   cif->flags = flags;
   cif->bytes = (unsigned) FFI_ALIGN (bytes, 8);
@@ -554,6 +653,70 @@ ffi_prep_cif_machdep (ffi_cif *cif)
   return FFI_OK;
 }
 
+/* The state after the fixed arguments of a variadic signature is the
+   number of integer and SSE registers they use; the stack space is
+   in VCIF->fixed.bytes.  Finding it examines the fixed arguments once
+   more, but only here, not for every tail.  */
+
+void FFI_HIDDEN
+ffi_prep_var_cif_machdep (ffi_var_cif *vcif)
+{
+  ffi_cif *cif = &vcif->fixed;
+  int gprcount = 0, ssecount = 0;
+  size_t bytes = 0;
+
+  if (cif->abi != FFI_UNIX64)
+    return;
+
+  if (cif->flags & UNIX64_FLAG_RET_IN_MEM)
+    gprcount++;
+  count_args (cif, 0, &gprcount, &ssecount, &bytes);
+  vcif->state[0] = gprcount;
+  vcif->state[1] = ssecount;
+}
+
+ffi_status FFI_HIDDEN
+ffi_prep_cif_var_tail_machdep (ffi_cif *cif, const ffi_var_cif *vcif)
+{
+  int gprcount = vcif->state[0], ssecount = vcif->state[1];
+  size_t bytes = vcif->fixed.bytes;
+
+  if (cif->abi != FFI_UNIX64)
+    return FFI_BAD_ABI;
+
+  count_args (cif, vcif->fixed.nargs, &gprcount, &ssecount, &bytes);
+  if (ssecount)
+    cif->flags |= UNIX64_FLAG_XMM_ARGS;
+  cif->bytes = (unsigned) FFI_ALIGN (bytes, 8);
+
+  /* The shape of the fixed arguments does not hold for the tail.  */
+  if (cif->flags & UNIX64_FLAG_REG_SHAPE)
+    {
+      cif->flags &= ~(UNIX64_FLAG_REG_SHAPE | (~0u << UNIX64_SIZE_SHIFT));
+      cif->flags |= reg_shape_flags (cif, cif->flags);
+    }
+
+  return FFI_OK;
+}
+
+/* Return the address of argument I of TYPE: AVALUE[I], or, if AVALUE
+   is NULL, its place in the packed block PACKED, where *OFF is the end
+   of the argument before it.  */
+
+static inline char *
+arg_address (ffi_type *type, void **avalue, const char *packed,
+	     unsigned i, size_t *off)
+{
+  char *a;
+
+  if (avalue != NULL)
+    return avalue[i];
+  *off = FFI_ALIGN (*off, type->alignment);
+  a = (char *) packed + *off;
+  *off += type->size;
+  return a;
+}
+
 #ifndef __SANITIZE_ADDRESS__
 # ifdef __clang__
 #  if __has_feature(address_sanitizer)
@@ -566,13 +729,16 @@ __attribute__((noinline,no_sanitize_address))
 #endif
 static void
 ffi_call_int (ffi_cif *cif, void (*fn)(void), void *rvalue,
-	      void **avalue, void *closure)
+	      void **avalue, const char *packed, void *closure,
+	      char *stack_top, int *errnop)
 {
   enum x86_64_reg_class classes[MAX_CLASSES];
   char *stack, *argp;
   ffi_type **arg_types;
   int gprcount, ssecount, ngpr, nsse, i, avn, flags;
   struct register_args *reg_args;
+  size_t size, off = 0;
+  int saved_errno = 0;
 
   /* Can't call 32-bit mode from 64-bit mode.  */
   FFI_ASSERT (cif->abi == FFI_UNIX64);
@@ -588,8 +754,13 @@ ffi_call_int (ffi_cif *cif, void (*fn)(void), void *rvalue,
 	flags = UNIX64_RET_VOID;
     }
 
-  /* Allocate the space for the arguments, plus 4 words of temp space.  */
-  stack = alloca (sizeof (struct register_args) + cif->bytes + 4*8);
+  /* Allocate the space for the arguments, plus 4 words of temp space.
+     On a separate stack, they go at its top.  */
+  size = sizeof (struct register_args) + cif->bytes + 4*8;
+  if (stack_top == NULL)
+    stack = alloca (size);
+  else
+    stack = (char *) ((uintptr_t) (stack_top - size) & -(uintptr_t) 16);
   reg_args = (struct register_args *) stack;
   argp = stack + sizeof (struct register_args);
 
@@ -608,6 +779,7 @@ ffi_call_int (ffi_cif *cif, void (*fn)(void), void *rvalue,
   for (i = 0; i < avn; ++i)
     {
       size_t n, size = arg_types[i]->size;
+      char *a = arg_address (arg_types[i], avalue, packed, i, &off);
 
       n = examine_argument (arg_types[i], classes, 0, &ngpr, &nsse);
       if (n == 0
@@ -622,13 +794,12 @@ ffi_call_int (ffi_cif *cif, void (*fn)(void), void *rvalue,
 
 	  /* Pass this argument in memory.  */
 	  argp = (void *) FFI_ALIGN (argp, align);
-	  memcpy (argp, avalue[i], size);
+	  memcpy (argp, a, size);
 	  argp += size;
 	}
       else
 	{
 	  /* The argument is passed entirely in registers.  */
-	  char *a = (char *) avalue[i];
 	  unsigned int j;
 
 	  for (j = 0; j < n; j++, a += 8, size -= 8)
@@ -676,8 +847,185 @@ ffi_call_int (ffi_cif *cif, void (*fn)(void), void *rvalue,
     }
   reg_args->rax = ssecount;
 
-  ffi_call_unix64 (stack, cif->bytes + sizeof (struct register_args),
-		   flags, rvalue, fn);
+  /* Nothing between the swaps and the call may touch errno.  */
+  if (errnop)
+    {
+      saved_errno = errno;
+      errno = *errnop;
+    }
+  if (stack_top == NULL)
+    ffi_call_unix64 (stack, cif->bytes + sizeof (struct register_args),
+		     flags, rvalue, fn);
+  else
+    ffi_call_unix64_on_stack (stack,
+			      cif->bytes + sizeof (struct register_args),
+			      flags, rvalue, fn);
+  if (errnop)
+    {
+      *errnop = errno;
+      errno = saved_errno;
+    }
+}
+
+/* The register-shape routines.  Each one returns a struct of an integer
+   and a double, which comes back in %rax and %xmm0, so that one routine
+   serves every scalar return type.
+
+   FN is called through a variadic type, so that the compiler sets %al
+   to the number of vector registers used, as ffi_call_unix64 does: a
+   variadic callee prepared with ffi_prep_cif still saves them.  The
+   arguments are passed in the same registers either way.  shape_0_0
+   passes a dummy integer, since a variadic type needs a named
+   parameter; it sets %al to 0.  */
+
+struct shape_ret
+{
+  UINT64 rax;
+  double xmm0;
+};
+
+typedef struct shape_ret (*shape_fn) (void (*fn)(void), const UINT64 *g,
+				      const double *x);
+
+#define SHAPE_GA1 g[0]
+#define SHAPE_GA2 SHAPE_GA1, g[1]
+#define SHAPE_GA3 SHAPE_GA2, g[2]
+#define SHAPE_GA4 SHAPE_GA3, g[3]
+#define SHAPE_GA5 SHAPE_GA4, g[4]
+#define SHAPE_GA6 SHAPE_GA5, g[5]
+#define SHAPE_XA2 x[0], x[1]
+#define SHAPE_XA4 SHAPE_XA2, x[2], x[3]
+#define SHAPE_XA8 SHAPE_XA4, x[4], x[5], x[6], x[7]
+
+#define SHAPE(NAME, FIRST, ARGS)					\
+  static struct shape_ret						\
+  NAME (void (*fn)(void), const UINT64 *g, const double *x)		\
+  {									\
+    (void) g;								\
+    (void) x;								\
+    return ((struct shape_ret (*) (FIRST, ...)) fn) ARGS;		\
+  }
+
+#define SHAPE_GPR(N)							\
+  SHAPE (shape_##N##_0, UINT64, (SHAPE_GA##N))				\
+  SHAPE (shape_##N##_2, UINT64, (SHAPE_GA##N, SHAPE_XA2))		\
+  SHAPE (shape_##N##_4, UINT64, (SHAPE_GA##N, SHAPE_XA4))		\
+  SHAPE (shape_##N##_8, UINT64, (SHAPE_GA##N, SHAPE_XA8))
+
+SHAPE (shape_0_0, UINT64, ((UINT64) 0))
+SHAPE (shape_0_2, double, (SHAPE_XA2))
+SHAPE (shape_0_4, double, (SHAPE_XA4))
+SHAPE (shape_0_8, double, (SHAPE_XA8))
+SHAPE_GPR (1)
+SHAPE_GPR (2)
+SHAPE_GPR (3)
+SHAPE_GPR (4)
+SHAPE_GPR (5)
+SHAPE_GPR (6)
+
+#define SHAPE_ROW(N) shape_##N##_0, shape_##N##_2, shape_##N##_4, shape_##N##_8
+
+static const shape_fn shape_fns[SHAPE_COUNT] = {
+  SHAPE_ROW (0), SHAPE_ROW (1), SHAPE_ROW (2), SHAPE_ROW (3),
+  SHAPE_ROW (4), SHAPE_ROW (5), SHAPE_ROW (6)
+};
+
+/* Inlined into each caller, so that the test for a pointer vector or
+   a packed block is made once rather than for every argument.  */
+
+static inline __attribute__((always_inline)) void
+ffi_call_reg_shape (ffi_cif *cif, void (*fn)(void), void *rvalue,
+		    void **avalue, const char *packed, int *errnop)
+{
+  unsigned shape = cif->flags >> UNIX64_SIZE_SHIFT;
+  unsigned i, ngpr = 0, nsse = 0;
+  UINT64 g[MAX_GPR_REGS];
+  double x[MAX_SSE_REGS];
+  struct shape_ret r;
+  size_t off = 0;
+  int saved_errno = 0;
+
+  for (i = 0; i < cif->nargs; i++)
+    {
+      char *a = arg_address (cif->arg_types[i], avalue, packed, i, &off);
+
+      /* Integers are extended as ffi_call_int does, see there.  */
+      switch (cif->arg_types[i]->type)
+	{
+	case FFI_TYPE_SINT8:
+	  g[ngpr++] = (SINT64) *(SINT8 *) a;
+	  break;
+	case FFI_TYPE_SINT16:
+	  g[ngpr++] = (SINT64) *(SINT16 *) a;
+	  break;
+	case FFI_TYPE_SINT32:
+	  g[ngpr++] = (SINT64) *(SINT32 *) a;
+	  break;
+	case FFI_TYPE_FLOAT:
+	  x[nsse] = 0;
+	  memcpy (&x[nsse++], a, sizeof (float));
+	  break;
+	case FFI_TYPE_DOUBLE:
+	  memcpy (&x[nsse++], a, sizeof (double));
+	  break;
+	default:
+	  g[ngpr] = 0;
+	  memcpy (&g[ngpr++], a, cif->arg_types[i]->size);
+	}
+    }
+  while (nsse < shape_sse_regs[shape % SHAPE_SSE_CLASSES])
+    x[nsse++] = 0;
+
+  if (errnop)
+    {
+      saved_errno = errno;
+      errno = *errnop;
+    }
+  r = shape_fns[shape] (fn, g, x);
+  if (errnop)
+    {
+      *errnop = errno;
+      errno = saved_errno;
+    }
+
+  if (rvalue == NULL)
+    return;
+
+  /* Store the return value as the store table in unix64.S does.  */
+  switch (cif->flags & 0xff)
+    {
+    case UNIX64_RET_VOID:
+      break;
+    case UNIX64_RET_UINT8:
+      *(UINT64 *) rvalue = (UINT8) r.rax;
+      break;
+    case UNIX64_RET_UINT16:
+      *(UINT64 *) rvalue = (UINT16) r.rax;
+      break;
+    case UNIX64_RET_UINT32:
+      *(UINT64 *) rvalue = (UINT32) r.rax;
+      break;
+    case UNIX64_RET_SINT8:
+      *(SINT64 *) rvalue = (SINT8) r.rax;
+      break;
+    case UNIX64_RET_SINT16:
+      *(SINT64 *) rvalue = (SINT16) r.rax;
+      break;
+    case UNIX64_RET_SINT32:
+      *(SINT64 *) rvalue = (SINT32) r.rax;
+      break;
+    case UNIX64_RET_INT64:
+      *(UINT64 *) rvalue = r.rax;
+      break;
+    case UNIX64_RET_XMM32:
+      memcpy (rvalue, &r.xmm0, sizeof (float));
+      break;
+    case UNIX64_RET_XMM64:
+      memcpy (rvalue, &r.xmm0, sizeof (double));
+      break;
+    default:
+      abort ();
+    }
 }
 
 #ifndef __ILP32__
@@ -685,17 +1033,173 @@ extern void
 ffi_call_efi64(ffi_cif *cif, void (*fn)(void), void *rvalue, void **avalue);
 #endif
 
-void
-ffi_call (ffi_cif *cif, void (*fn)(void), void *rvalue, void **avalue)
+/* ERRNOP is NULL except for ffi_call_errno.  */
+
+static inline void
+ffi_call_dispatch (ffi_cif *cif, void (*fn)(void), void *rvalue,
+		   void **avalue, int *errnop)
 {
 #ifndef __ILP32__
   if (cif->abi == FFI_EFI64 || cif->abi == FFI_GNUW64)
     {
+      int saved_errno = 0;
+
+      if (errnop)
+	{
+	  saved_errno = errno;
+	  errno = *errnop;
+	}
       ffi_call_efi64(cif, fn, rvalue, avalue);
+      if (errnop)
+	{
+	  *errnop = errno;
+	  errno = saved_errno;
+	}
       return;
     }
 #endif
-  ffi_call_int (cif, fn, rvalue, avalue, NULL);
+  if (cif->flags & (UNIX64_FLAG_REG_SHAPE | UNIX64_FLAG_CIF_INFO))
+    {
+      unsigned long long start = 0;
+      ffi_cif_info *info = NULL;
+      ffi_plan *plan;
+
+      /* A promoted cif goes straight to its plan.  Register-shape cifs
+	 are never promoted.  */
+      if ((cif->flags & (UNIX64_FLAG_REG_SHAPE | UNIX64_FLAG_CIF_INFO))
+	  == UNIX64_FLAG_CIF_INFO
+	  && errnop == NULL && (plan = ffi_tier_plan (cif)) != NULL)
+	{
+	  ffi_call_plan_machdep (plan, fn, rvalue, avalue);
+	  return;
+	}
+
+      if (cif->flags & UNIX64_FLAG_CIF_INFO)
+	start = ffi_cif_info_enter (cif, FFI_CIF_INFO_CALL, &info);
+      if (cif->flags & UNIX64_FLAG_REG_SHAPE)
+	ffi_call_reg_shape (cif, fn, rvalue, avalue, NULL, errnop);
+      else if (info != NULL && info->plan != NULL && errnop == NULL
+	       && info->plan->cif == cif)
+	ffi_call_plan_machdep (info->plan, fn, rvalue, avalue);
+      else
+	ffi_call_int (cif, fn, rvalue, avalue, NULL, NULL, NULL, errnop);
+      if (cif->flags & UNIX64_FLAG_CIF_INFO)
+	ffi_cif_info_leave (info, cif, FFI_CIF_INFO_CALL, start);
+    }
+  else
+    {
+      ffi_tier_count (cif);
+      ffi_call_int (cif, fn, rvalue, avalue, NULL, NULL, NULL, errnop);
+    }
+}
+
+void
+ffi_call (ffi_cif *cif, void (*fn)(void), void *rvalue, void **avalue)
+{
+  FFI_PROBE3 (call__entry, cif, fn, cif->nargs);
+  FFI_RECORD (cif, 0);
+  ffi_call_dispatch (cif, fn, rvalue, avalue, NULL);
+  FFI_PROBE2 (call__return, cif, fn);
+}
+
+/* The errno swaps are made in ffi_call_int and ffi_call_reg_shape,
+   right around the call, so that hooks and argument marshalling
+   cannot disturb them.  */
+
+void
+ffi_call_errno (ffi_cif *cif, void (*fn)(void), void *rvalue,
+		void **avalue, int *errnop)
+{
+  FFI_PROBE3 (call__entry, cif, fn, cif->nargs);
+  FFI_RECORD (cif, 0);
+  ffi_call_dispatch (cif, fn, rvalue, avalue, errnop);
+  FFI_PROBE2 (call__return, cif, fn);
+}
+
+/* The arguments are marshalled straight from the packed block, as
+   ffi_call marshals them from the values AVALUE points to.  Plans take
+   a pointer vector, so a promoted cif is not called through its plan
+   here.  */
+
+void
+ffi_call_packed (ffi_cif *cif, void (*fn)(void), void *rvalue,
+		 const void *args)
+{
+  unsigned long long start = 0;
+  ffi_cif_info *info = NULL;
+
+  if (cif->abi != FFI_UNIX64)
+    {
+      size_t *offsets = alloca (cif->nargs * sizeof (size_t));
+      void **avalue = alloca (cif->nargs * sizeof (void *));
+      unsigned i;
+
+      ffi_get_packed_offsets (cif, offsets, NULL);
+      for (i = 0; i < cif->nargs; i++)
+	avalue[i] = (char *) args + offsets[i];
+      ffi_call (cif, fn, rvalue, avalue);
+      return;
+    }
+
+  FFI_PROBE3 (call__entry, cif, fn, cif->nargs);
+  FFI_RECORD (cif, 0);
+  if (cif->flags & UNIX64_FLAG_CIF_INFO)
+    start = ffi_cif_info_enter (cif, FFI_CIF_INFO_CALL, &info);
+  if (cif->flags & UNIX64_FLAG_REG_SHAPE)
+    ffi_call_reg_shape (cif, fn, rvalue, NULL, args, NULL);
+  else
+    ffi_call_int (cif, fn, rvalue, NULL, args, NULL, NULL, NULL);
+  if (cif->flags & UNIX64_FLAG_CIF_INFO)
+    ffi_cif_info_leave (info, cif, FFI_CIF_INFO_CALL, start);
+  FFI_PROBE2 (call__return, cif, fn);
+}
+
+/* Only cifs with state in the side table are marked, so that all other
+   calls test a flag they test anyway.  */
+
+ffi_status FFI_HIDDEN
+ffi_cif_info_machdep (ffi_cif *cif, int active)
+{
+  if (cif->abi != FFI_UNIX64)
+    return FFI_BAD_ABI;
+
+  /* Other threads may be calling through CIF.  */
+  if (active)
+    __atomic_fetch_or (&cif->flags, UNIX64_FLAG_CIF_INFO, __ATOMIC_RELAXED);
+  else
+    __atomic_fetch_and (&cif->flags, ~UNIX64_FLAG_CIF_INFO,
+			__ATOMIC_RELAXED);
+  return FFI_OK;
+}
+
+/* The register-shape routines would run on the current stack, so calls
+   on another stack always go through ffi_call_int.  */
+
+ffi_status
+ffi_call_on_stack (ffi_cif *cif, void (*fn)(void), void *rvalue,
+		   void **avalue, void *stack_base, size_t stack_size)
+{
+  unsigned long long start = 0;
+  ffi_cif_info *info = NULL;
+
+  if (cif->abi != FFI_UNIX64)
+    return FFI_BAD_ABI;
+
+  /* The register block, the outgoing arguments, the frame of
+     ffi_call_unix64 and the alignment of the top.  */
+  if (stack_size < sizeof (struct register_args) + (size_t) cif->bytes
+		   + 4*8 + 16)
+    return FFI_BAD_ARGTYPE;
+  FFI_PROBE3 (call__entry, cif, fn, cif->nargs);
+  FFI_RECORD (cif, 0);
+  if (cif->flags & UNIX64_FLAG_CIF_INFO)
+    start = ffi_cif_info_enter (cif, FFI_CIF_INFO_CALL, &info);
+  ffi_call_int (cif, fn, rvalue, avalue, NULL, NULL,
+		(char *) stack_base + stack_size, NULL);
+  if (cif->flags & UNIX64_FLAG_CIF_INFO)
+    ffi_cif_info_leave (info, cif, FFI_CIF_INFO_CALL, start);
+  FFI_PROBE2 (call__return, cif, fn);
+  return FFI_OK;
 }
 
 #ifdef FFI_GO_CLOSURES
@@ -717,13 +1221,288 @@ ffi_call_go (ffi_cif *cif, void (*fn)(void), void *rvalue,
       return;
     }
 #endif
-  ffi_call_int (cif, fn, rvalue, avalue, closure);
+  ffi_call_int (cif, fn, rvalue, avalue, NULL, closure, NULL, NULL);
 }
 
 #endif /* FFI_GO_CLOSURES */
 
+/* Lower a cif into a call plan.  The call image is exactly what
+   ffi_call_int builds on each call: a struct register_args followed by
+   the outgoing stack arguments and the 4 words of temp space used by
+   ffi_call_unix64.  */
+
+ffi_status FFI_HIDDEN
+ffi_prep_plan_machdep (ffi_plan *plan)
+{
+  enum x86_64_reg_class classes[MAX_CLASSES];
+  ffi_cif *cif = plan->cif;
+  ffi_plan_step *step = plan->steps;
+  int gprcount, ssecount, ngpr, nsse;
+  unsigned i, j, argp;
+
+  /* Plans of cifs with hooks defer to ffi_call, which runs them.  */
+  if (cif->abi != FFI_UNIX64
+      || ((cif->flags & UNIX64_FLAG_CIF_INFO) && ffi_cif_info_observed (cif)))
+    return FFI_BAD_ABI;
+
+  gprcount = ssecount = 0;
+  argp = sizeof (struct register_args);
+
+  if (cif->flags & UNIX64_FLAG_RET_IN_MEM)
+    {
+      step->op = FFI_PLAN_RVALUE;
+      step->dst = offsetof (struct register_args, gpr)
+			  + gprcount++ * sizeof (UINT64);
+      step++;
+      plan->rsize = cif->rtype->size;
+    }
+
+  for (i = 0; i < cif->nargs; ++i)
+    {
+      ffi_type *type = cif->arg_types[i];
+      size_t n, size = type->size;
+
+      n = examine_argument (type, classes, 0, &ngpr, &nsse);
+      if (n == 0
+	  || gprcount + ngpr > MAX_GPR_REGS
+	  || ssecount + nsse > MAX_SSE_REGS)
+	{
+	  long align = type->alignment;
+
+	  /* Stack arguments are *always* at least 8 byte aligned.  */
+	  if (align < 8)
+	    align = 8;
+
+	  argp = FFI_ALIGN (argp, align);
+	  step->op = FFI_PLAN_COPY;
+	  step->arg = i;
+	  step->src = 0;
+	  step->dst = argp;
+	  step->size = size;
+	  step++;
+	  argp += size;
+	  continue;
+	}
+
+      for (j = 0; j < n; j++, size -= 8)
+	{
+	  step->arg = i;
+	  step->src = j * 8;
+	  switch (classes[j])
+	    {
+	    case X86_64_NO_CLASS:
+	    case X86_64_SSEUP_CLASS:
+	      continue;
+	    case X86_64_INTEGER_CLASS:
+	    case X86_64_INTEGERSI_CLASS:
+	      /* Sign-extend as ffi_call_int does, see there.  */
+	      switch (type->type)
+		{
+		case FFI_TYPE_SINT8:
+		  step->op = FFI_PLAN_SINT8;
+		  break;
+		case FFI_TYPE_SINT16:
+		  step->op = FFI_PLAN_SINT16;
+		  break;
+		case FFI_TYPE_SINT32:
+		  step->op = FFI_PLAN_SINT32;
+		  break;
+		default:
+		  step->op = FFI_PLAN_SLOT;
+		}
+	      step->dst = offsetof (struct register_args, gpr)
+			  + gprcount++ * sizeof (UINT64);
+	      step->size = size < 8 ? size : 8;
+	      break;
+	    case X86_64_SSE_CLASS:
+	    case X86_64_SSEDF_CLASS:
+	      step->op = FFI_PLAN_COPY;
+	      step->dst = offsetof (struct register_args, sse)
+			  + ssecount++ * sizeof (union big_int_union);
+	      step->size = sizeof (UINT64);
+	      break;
+	    case X86_64_SSESF_CLASS:
+	      step->op = FFI_PLAN_COPY;
+	      step->dst = offsetof (struct register_args, sse)
+			  + ssecount++ * sizeof (union big_int_union);
+	      step->size = sizeof (UINT32);
+	      break;
+	    default:
+	      abort ();
+	    }
+	  step++;
+	}
+    }
+
+  step->op = FFI_PLAN_CONST;
+  step->src = ssecount;
+  step->dst = offsetof (struct register_args, rax);
+  step++;
+  step->op = FFI_PLAN_CONST;
+  step->src = 0;
+  step->dst = offsetof (struct register_args, r10);
+  step++;
+
+  plan->nsteps = step - plan->steps;
+  plan->image_size = sizeof (struct register_args) + cif->bytes + 4*8;
+
+  return FFI_OK;
+}
+
+#ifdef __SANITIZE_ADDRESS__
+__attribute__((noinline,no_sanitize_address))
+#endif
+void FFI_HIDDEN
+ffi_call_plan_machdep (const ffi_plan *plan, void (*fn)(void),
+		       void *rvalue, void **avalue)
+{
+  unsigned flags = plan->flags;
+  char *image;
+
+  if (rvalue == NULL)
+    {
+      if (flags & UNIX64_FLAG_RET_IN_MEM)
+	rvalue = alloca (plan->rsize);
+      else
+	flags = UNIX64_RET_VOID;
+    }
+
+  /* The image must live in this frame: ffi_call_unix64 uses it as its
+     own stack frame and returns with the stack pointer past it.  */
+  image = alloca (plan->image_size);
+  if (plan->image_init)
+    memcpy (image, plan->image_init, plan->image_size);
+  ffi_plan_run (plan, image, rvalue, avalue);
+
+  ffi_call_unix64 (image, plan->image_size - 4*8, flags, rvalue, fn);
+}
+
+/* A call image is the struct register_args and outgoing stack block
+   that ffi_call_unix64 consumes, without its 4 words of temp space.
+   The hidden return pointer, %rax and %r10 are filled in by
+   ffi_call_image, so they are not part of the layout.  */
+
+ffi_status
+ffi_get_image_layout (ffi_cif *cif, ffi_image_layout *layout,
+		      size_t *offsets)
+{
+  enum x86_64_reg_class classes[MAX_CLASSES];
+  int gprcount, ssecount, ngpr, nsse;
+  unsigned i, j, n;
+  size_t argp;
+
+  if (cif->abi != FFI_UNIX64)
+    return FFI_BAD_ABI;
+
+  gprcount = ssecount = 0;
+  if (cif->flags & UNIX64_FLAG_RET_IN_MEM)
+    gprcount++;
+
+  layout->size = sizeof (struct register_args) + cif->bytes;
+  layout->stack_offset = sizeof (struct register_args);
+  layout->stack_size = cif->bytes;
+  layout->gpr_offset = offsetof (struct register_args, gpr)
+		       + gprcount * sizeof (UINT64);
+  layout->gpr_size = sizeof (UINT64);
+  layout->gpr_count = MAX_GPR_REGS - gprcount;
+  layout->fpr_offset = offsetof (struct register_args, sse);
+  layout->fpr_size = sizeof (union big_int_union);
+  layout->fpr_count = MAX_SSE_REGS;
+
+  if (offsets == NULL)
+    return FFI_OK;
+
+  argp = sizeof (struct register_args);
+  for (i = 0; i < cif->nargs; ++i)
+    {
+      ffi_type *type = cif->arg_types[i];
+
+      n = examine_argument (type, classes, 0, &ngpr, &nsse);
+      if (n == 0
+	  || gprcount + ngpr > MAX_GPR_REGS
+	  || ssecount + nsse > MAX_SSE_REGS)
+	{
+	  long align = type->alignment;
+
+	  /* Stack arguments are *always* at least 8 byte aligned.  */
+	  if (align < 8)
+	    align = 8;
+
+	  argp = FFI_ALIGN (argp, align);
+	  offsets[i] = argp;
+	  argp += type->size;
+	  continue;
+	}
+
+      /* An argument is contiguous if it is only in general registers,
+	 which are adjacent in the image, or in a single SSE register.  */
+      if (nsse == 0)
+	offsets[i] = offsetof (struct register_args, gpr)
+		     + gprcount * sizeof (UINT64);
+      else if (ngpr == 0 && nsse == 1)
+	offsets[i] = offsetof (struct register_args, sse)
+		     + ssecount * sizeof (union big_int_union);
+      else
+	offsets[i] = FFI_IMAGE_SPLIT;
+
+      for (j = 0; j < n; j++)
+	if (classes[j] == X86_64_SSE_CLASS
+	    || classes[j] == X86_64_SSESF_CLASS
+	    || classes[j] == X86_64_SSEDF_CLASS)
+	  ssecount++;
+	else if (classes[j] != X86_64_NO_CLASS
+		 && classes[j] != X86_64_SSEUP_CLASS)
+	  gprcount++;
+    }
+
+  return FFI_OK;
+}
+
+#ifdef __SANITIZE_ADDRESS__
+__attribute__((noinline,no_sanitize_address))
+#endif
+void
+ffi_call_image (ffi_cif *cif, void (*fn)(void), void *rvalue,
+		const void *image)
+{
+  size_t bytes = sizeof (struct register_args) + cif->bytes;
+  unsigned flags = cif->flags;
+  struct register_args *reg_args;
+  char *stack;
+
+  FFI_ASSERT (cif->abi == FFI_UNIX64);
+
+  if (rvalue == NULL)
+    {
+      if (flags & UNIX64_FLAG_RET_IN_MEM)
+	rvalue = alloca (cif->rtype->size);
+      else
+	flags = UNIX64_RET_VOID;
+    }
+
+  /* As with plans, the image must be copied into this frame, since
+     ffi_call_unix64 uses it as its own stack frame.  */
+  stack = alloca (bytes + 4*8);
+  memcpy (stack, image, bytes);
+  reg_args = (struct register_args *) stack;
+
+  if (flags & UNIX64_FLAG_RET_IN_MEM)
+    reg_args->gpr[0] = (uintptr_t) rvalue;
+  /* %al need only be an upper bound on the SSE registers used.  */
+  reg_args->rax = cif->flags & UNIX64_FLAG_XMM_ARGS ? MAX_SSE_REGS : 0;
+  reg_args->r10 = 0;
+
+  ffi_call_unix64 (stack, bytes, flags, rvalue, fn);
+}
+
 extern void ffi_closure_unix64(void) FFI_HIDDEN;
 extern void ffi_closure_unix64_sse(void) FFI_HIDDEN;
+/* The offsets of the register-shape closure entries, see unix64.S.  */
+extern const int32_t ffi_closure_unix64_shapes[SHAPE_COUNT] FFI_HIDDEN;
+extern void ffi_closure_unix64_typed(void) FFI_HIDDEN;
+extern void ffi_closure_unix64_packed(void) FFI_HIDDEN;
+extern void ffi_closure_unix64_packed_sse(void) FFI_HIDDEN;
+extern void ffi_closure_unix64_packed_shape(void) FFI_HIDDEN;
 
 #ifndef __ILP32__
 extern ffi_status
@@ -734,12 +1513,11 @@ ffi_prep_closure_loc_efi64(ffi_closure* closure,
 			   void *codeloc);
 #endif
 
-ffi_status
-ffi_prep_closure_loc (ffi_closure* closure,
-		      ffi_cif* cif,
-		      void (*fun)(ffi_cif*, void*, void**, void*),
-		      void *user_data,
-		      void *codeloc)
+/* Fill in the trampoline of a closure, which loads the address of the
+   closure into %r10 and jumps to DEST.  */
+
+static void
+unix64_prep_trampoline (char *tramp, void (*dest)(void))
 {
   static const unsigned char trampoline[24] = {
     /* endbr64 */
@@ -751,8 +1529,60 @@ ffi_prep_closure_loc (ffi_closure* closure,
     /* nopl  0(%rax) */
     0x0f, 0x1f, 0x80, 0x00, 0x00, 0x00, 0x00
   };
+
+  memcpy (tramp, trampoline, sizeof(trampoline));
+  *(UINT64 *)(tramp + sizeof (trampoline)) = (uintptr_t)dest;
+}
+
+/* The trampolines only jump, so anywhere in them the CFA is %rsp + 8
+   and the return address is just below it, as on entry to a function.
+   That is also all the CIE says, so the FDE has no instructions.  */
+
+void FFI_HIDDEN
+ffi_exec_cfi_machdep (void *frame, void *code, size_t length)
+{
+  static const unsigned char cie[24] = {
+    /* Length, CIE id, version, no augmentation.  */
+    20, 0, 0, 0,  0, 0, 0, 0,  1,  0,
+    /* Code and data alignment factors, return address column.  */
+    1,  0x78,  16,
+    /* DW_CFA_def_cfa %rsp, 8; DW_CFA_offset %rip, -8.  */
+    0x0c, 7, 8,  0x90, 1,
+    /* DW_CFA_nop padding.  */
+    0, 0, 0, 0, 0, 0
+  };
+  unsigned char *p = frame;
+  UINT32 word;
+  UINT64 addr;
+
+  FFI_ASSERT (sizeof (cie) + 24 + 4 <= FFI_EXEC_CFI_SIZE);
+  memcpy (p, cie, sizeof (cie));
+  p += sizeof (cie);
+
+  /* The FDE: length, offset back to the CIE, pc_begin, pc_range.  */
+  word = 20;
+  memcpy (p, &word, 4);
+  word = sizeof (cie) + 4;
+  memcpy (p + 4, &word, 4);
+  addr = (uintptr_t) code;
+  memcpy (p + 8, &addr, 8);
+  addr = length;
+  memcpy (p + 16, &addr, 8);
+  p += 24;
+
+  /* The terminator.  */
+  word = 0;
+  memcpy (p, &word, 4);
+}
+
+ffi_status
+ffi_prep_closure_loc (ffi_closure* closure,
+		      ffi_cif* cif,
+		      void (*fun)(ffi_cif*, void*, void**, void*),
+		      void *user_data,
+		      void *codeloc)
+{
   void (*dest)(void);
-  char *tramp = closure->tramp;
 
 #ifndef __ILP32__
   if (cif->abi == FFI_EFI64 || cif->abi == FFI_GNUW64)
@@ -761,17 +1591,89 @@ ffi_prep_closure_loc (ffi_closure* closure,
   if (cif->abi != FFI_UNIX64)
     return FFI_BAD_ABI;
 
-  if (cif->flags & UNIX64_FLAG_XMM_ARGS)
+  if (cif->flags & UNIX64_FLAG_REG_SHAPE)
+    {
+      unsigned shape = cif->flags >> UNIX64_SIZE_SHIFT;
+
+      dest = (void (*)(void)) ((const char *) ffi_closure_unix64_shapes
+			       + ffi_closure_unix64_shapes[shape]);
+    }
+  else if (cif->flags & UNIX64_FLAG_XMM_ARGS)
     dest = ffi_closure_unix64_sse;
   else
     dest = ffi_closure_unix64;
 
-  memcpy (tramp, trampoline, sizeof(trampoline));
-  *(UINT64 *)(tramp + sizeof (trampoline)) = (uintptr_t)dest;
+  unix64_prep_trampoline (closure->tramp, dest);
 
   closure->cif = cif;
   closure->fun = fun;
   closure->user_data = user_data;
+  ffi_perf_map_closure (codeloc, FFI_TRAMPOLINE_SIZE, cif, (void *) fun);
+
+  return FFI_OK;
+}
+
+/* A typed closure needs a register shape with an integer register to
+   spare for user_data; ffi_closure_unix64_typed then only has to shift
+   the integer registers.  */
+
+ffi_status
+ffi_prep_typed_closure_loc (ffi_closure* closure,
+			    ffi_cif* cif,
+			    void (*fun)(void),
+			    void *user_data,
+			    void *codeloc)
+{
+  unsigned shape;
+
+  /* ffi_closure_unix64_typed enters FUN directly, leaving no place to
+     run hooks.  */
+  if (cif->abi != FFI_UNIX64 || !(cif->flags & UNIX64_FLAG_REG_SHAPE)
+      || (cif->flags & UNIX64_FLAG_CIF_INFO))
+    return FFI_BAD_ABI;
+  shape = cif->flags >> UNIX64_SIZE_SHIFT;
+  if (shape / SHAPE_SSE_CLASSES >= MAX_GPR_REGS)
+    return FFI_BAD_ABI;
+
+  unix64_prep_trampoline (closure->tramp, ffi_closure_unix64_typed);
+
+  closure->cif = cif;
+  closure->fun = (void (*)(ffi_cif*, void*, void**, void*)) fun;
+  closure->user_data = user_data;
+  ffi_perf_map_closure (codeloc, FFI_TRAMPOLINE_SIZE, cif, (void *) fun);
+
+  return FFI_OK;
+}
+
+/* A packed closure enters through ffi_closure_unix64_packed, which
+   saves the argument registers like ffi_closure_unix64 but calls
+   ffi_closure_unix64_packed_inner, or, if its cif has a register
+   shape, through ffi_closure_unix64_packed_shape.  */
+
+ffi_status
+ffi_prep_packed_closure_loc (ffi_closure* closure,
+			     ffi_cif* cif,
+			     void (*fun)(ffi_cif*, void*, void*, void*),
+			     void *user_data,
+			     void *codeloc)
+{
+  void (*dest)(void);
+
+  if (cif->abi != FFI_UNIX64)
+    return FFI_BAD_ABI;
+
+  if (cif->flags & UNIX64_FLAG_REG_SHAPE)
+    dest = ffi_closure_unix64_packed_shape;
+  else if (cif->flags & UNIX64_FLAG_XMM_ARGS)
+    dest = ffi_closure_unix64_packed_sse;
+  else
+    dest = ffi_closure_unix64_packed;
+  unix64_prep_trampoline (closure->tramp, dest);
+
+  closure->cif = cif;
+  closure->fun = (void (*)(ffi_cif*, void*, void**, void*)) fun;
+  closure->user_data = user_data;
+  ffi_perf_map_closure (codeloc, FFI_TRAMPOLINE_SIZE, cif, (void *) fun);
 
   return FFI_OK;
 }
@@ -799,6 +1701,8 @@ ffi_closure_unix64_inner(ffi_cif *cif,
   long i, avn;
   int gprcount, ssecount, ngpr, nsse;
   int flags;
+  unsigned long long start = 0;
+  ffi_cif_info *info = NULL;
 
   avn = cif->nargs;
   flags = cif->flags;
@@ -873,12 +1777,292 @@ ffi_closure_unix64_inner(ffi_cif *cif,
     }
 
   /* Invoke the closure.  */
+  FFI_PROBE3 (closure__entry, cif, fun, cif->nargs);
+  FFI_RECORD (cif, 1);
+  if (cif->flags & UNIX64_FLAG_CIF_INFO)
+    start = ffi_cif_info_enter (cif, FFI_CIF_INFO_CLOSURE, &info);
   fun (cif, rvalue, avalue, user_data);
+  if (cif->flags & UNIX64_FLAG_CIF_INFO)
+    ffi_cif_info_leave (info, cif, FFI_CIF_INFO_CLOSURE, start);
+  FFI_PROBE2 (closure__return, cif, fun);
+
+  /* Tell assembly how to perform return type promotions.  */
+  return flags;
+}
+
+/* The inner function of the packed closures.  Like
+   ffi_closure_unix64_inner, but each argument is copied into a block
+   laid out as by ffi_get_packed_offsets, instead of being pointed
+   to.  */
+
+#ifdef __SANITIZE_ADDRESS__
+__attribute__((noinline,no_sanitize_address))
+#endif
+int FFI_HIDDEN
+ffi_closure_unix64_packed_inner (ffi_cif *cif,
+				 void (*fun)(ffi_cif*, void*, void*, void*),
+				 void *user_data,
+				 void *rvalue,
+				 struct register_args *reg_args,
+				 char *argp)
+{
+  ffi_type **arg_types;
+  char *block;
+  size_t off;
+  unsigned i;
+  int gprcount, ssecount, ngpr, nsse;
+  int flags;
+  unsigned long long start = 0;
+  ffi_cif_info *info = NULL;
+
+  /* The arguments take no more than the registers and the stack space
+     they came in.  An argument is padded by less than its alignment,
+     which is at most its size, and the block by less than 16 bytes.  */
+  flags = cif->flags;
+  block = alloca (2 * (sizeof (struct register_args) + cif->bytes) + 16);
+  gprcount = ssecount = 0;
+
+  if (flags & UNIX64_FLAG_RET_IN_MEM)
+    {
+      /* On return, %rax will contain the address that was passed
+	 by the caller in %rdi.  */
+      void *r = (void *)(uintptr_t)reg_args->gpr[gprcount++];
+      *(void **)rvalue = r;
+      rvalue = r;
+      flags = (sizeof(void *) == 4 ? UNIX64_RET_UINT32 : UNIX64_RET_INT64);
+    }
+
+  arg_types = cif->arg_types;
+  for (i = off = 0; i < cif->nargs; ++i)
+    {
+      enum x86_64_reg_class classes[MAX_CLASSES];
+      ffi_type *type = arg_types[i];
+      char *dst;
+      size_t n, j, left;
+
+      off = FFI_ALIGN (off, type->alignment);
+      dst = block + off;
+      off += type->size;
+
+      /* Scalars that still fit in registers need no classification.  */
+      switch (type->type)
+	{
+	case FFI_TYPE_FLOAT:
+	case FFI_TYPE_DOUBLE:
+	  if (ssecount < MAX_SSE_REGS)
+	    {
+	      if (type->type == FFI_TYPE_FLOAT)
+		*(UINT32 *) dst = reg_args->sse[ssecount++].i32;
+	      else
+		*(UINT64 *) dst = reg_args->sse[ssecount++].i64;
+	      continue;
+	    }
+	  break;
+	case FFI_TYPE_INT:
+	case FFI_TYPE_UINT8:
+	case FFI_TYPE_SINT8:
+	case FFI_TYPE_UINT16:
+	case FFI_TYPE_SINT16:
+	case FFI_TYPE_UINT32:
+	case FFI_TYPE_SINT32:
+	case FFI_TYPE_UINT64:
+	case FFI_TYPE_SINT64:
+	case FFI_TYPE_POINTER:
+	  if (gprcount < MAX_GPR_REGS)
+	    {
+	      UINT64 v = reg_args->gpr[gprcount++];
+
+	      switch (type->size)
+		{
+		case 1:
+		  *(UINT8 *) dst = (UINT8) v;
+		  break;
+		case 2:
+		  *(UINT16 *) dst = (UINT16) v;
+		  break;
+		case 4:
+		  *(UINT32 *) dst = (UINT32) v;
+		  break;
+		default:
+		  *(UINT64 *) dst = v;
+		}
+	      continue;
+	    }
+	  break;
+	}
+
+      n = examine_argument (type, classes, 0, &ngpr, &nsse);
+      if (n == 0
+	  || gprcount + ngpr > MAX_GPR_REGS
+	  || ssecount + nsse > MAX_SSE_REGS)
+	{
+	  long align = type->alignment;
+
+	  /* Stack arguments are *always* at least 8 byte aligned.  */
+	  if (align < 8)
+	    align = 8;
+
+	  argp = (void *) FFI_ALIGN (argp, align);
+	  memcpy (dst, argp, type->size);
+	  argp += type->size;
+	  continue;
+	}
+
+      for (j = 0, left = type->size; j < n; j++, dst += 8, left -= 8)
+	{
+	  size_t len = left < 8 ? left : 8;
+
+	  switch (classes[j])
+	    {
+	    case X86_64_NO_CLASS:
+	    case X86_64_SSEUP_CLASS:
+	      break;
+	    case X86_64_SSE_CLASS:
+	    case X86_64_SSESF_CLASS:
+	    case X86_64_SSEDF_CLASS:
+	      memcpy (dst, &reg_args->sse[ssecount++], len);
+	      break;
+	    default:
+	      memcpy (dst, &reg_args->gpr[gprcount++], len);
+	    }
+	}
+    }
+
+  /* Invoke the closure.  */
+  FFI_PROBE3 (closure__entry, cif, fun, cif->nargs);
+  FFI_RECORD (cif, 1);
+  if (cif->flags & UNIX64_FLAG_CIF_INFO)
+    start = ffi_cif_info_enter (cif, FFI_CIF_INFO_CLOSURE, &info);
+  fun (cif, rvalue, block, user_data);
+  if (cif->flags & UNIX64_FLAG_CIF_INFO)
+    ffi_cif_info_leave (info, cif, FFI_CIF_INFO_CLOSURE, start);
+  FFI_PROBE2 (closure__return, cif, fun);
 
   /* Tell assembly how to perform return type promotions.  */
   return flags;
 }
 
+/* The assembly loads the first 8 bytes of RVALUE into both %rax and
+   %xmm0, so perform the promotions of its load table here.  */
+
+static void
+shape_promote (ffi_cif *cif, void *rvalue)
+{
+  switch (cif->flags & 0xff)
+    {
+    case UNIX64_RET_UINT8:
+      *(UINT64 *) rvalue = *(UINT8 *) rvalue;
+      break;
+    case UNIX64_RET_UINT16:
+      *(UINT64 *) rvalue = *(UINT16 *) rvalue;
+      break;
+    case UNIX64_RET_UINT32:
+      *(UINT64 *) rvalue = *(UINT32 *) rvalue;
+      break;
+    case UNIX64_RET_SINT8:
+      *(SINT64 *) rvalue = *(SINT8 *) rvalue;
+      break;
+    case UNIX64_RET_SINT16:
+      *(SINT64 *) rvalue = *(SINT16 *) rvalue;
+      break;
+    case UNIX64_RET_SINT32:
+      *(SINT64 *) rvalue = *(SINT32 *) rvalue;
+      break;
+    }
+}
+
+/* The inner function of the packed closures with a register shape.
+   REGS is laid out as for ffi_closure_unix64_shape_inner.  Every
+   argument is a scalar of at most 8 bytes, aligned to its size, so the
+   block takes at most 8 bytes per argument.  The x86-64 is little
+   endian, so the low bytes of each register are the argument.  */
+
+void FFI_HIDDEN
+ffi_closure_unix64_packed_shape_inner (ffi_cif *cif,
+				       void (*fun)(ffi_cif*, void*, void*,
+						   void*),
+				       void *user_data,
+				       void *rvalue,
+				       UINT64 *regs)
+{
+  UINT64 *gpr = regs, *sse = regs + MAX_GPR_REGS;
+  char *block = alloca (cif->nargs * 8 + 8);
+  size_t off = 0;
+  unsigned i;
+  unsigned long long start = 0;
+  ffi_cif_info *info = NULL;
+
+  /* Store all 8 bytes of each register.  The bytes past the argument
+     land in padding or under the next argument, which is stored after
+     it; this is what the extra 8 bytes of BLOCK are for.  */
+  for (i = 0; i < cif->nargs; i++)
+    {
+      ffi_type *type = cif->arg_types[i];
+      UINT64 v;
+
+      off = FFI_ALIGN (off, type->alignment);
+      if (type->type == FFI_TYPE_FLOAT || type->type == FFI_TYPE_DOUBLE)
+	v = *sse++;
+      else
+	v = *gpr++;
+      memcpy (block + off, &v, 8);
+      off += type->size;
+    }
+
+  FFI_PROBE3 (closure__entry, cif, fun, cif->nargs);
+  FFI_RECORD (cif, 1);
+  if (cif->flags & UNIX64_FLAG_CIF_INFO)
+    start = ffi_cif_info_enter (cif, FFI_CIF_INFO_CLOSURE, &info);
+  fun (cif, rvalue, block, user_data);
+  if (cif->flags & UNIX64_FLAG_CIF_INFO)
+    ffi_cif_info_leave (info, cif, FFI_CIF_INFO_CLOSURE, start);
+  FFI_PROBE2 (closure__return, cif, fun);
+
+  shape_promote (cif, rvalue);
+}
+
+/* The inner function of the register-shape closures.  REGS holds the
+   6 integer registers followed by the low 8 bytes of the 8 SSE
+   registers; the arguments are taken from them in order, without
+   classifying them.  */
+
+void FFI_HIDDEN
+ffi_closure_unix64_shape_inner (ffi_cif *cif,
+				void (*fun)(ffi_cif*, void*, void**, void*),
+				void *user_data,
+				void *rvalue,
+				UINT64 *regs)
+{
+  UINT64 *gpr = regs, *sse = regs + MAX_GPR_REGS;
+  void **avalue;
+  unsigned i;
+  unsigned long long start = 0;
+  ffi_cif_info *info = NULL;
+
+  avalue = alloca (cif->nargs * sizeof (void *));
+  for (i = 0; i < cif->nargs; i++)
+    switch (cif->arg_types[i]->type)
+      {
+      case FFI_TYPE_FLOAT:
+      case FFI_TYPE_DOUBLE:
+	avalue[i] = sse++;
+	break;
+      default:
+	avalue[i] = gpr++;
+      }
+
+  FFI_PROBE3 (closure__entry, cif, fun, cif->nargs);
+  FFI_RECORD (cif, 1);
+  if (cif->flags & UNIX64_FLAG_CIF_INFO)
+    start = ffi_cif_info_enter (cif, FFI_CIF_INFO_CLOSURE, &info);
+  fun (cif, rvalue, avalue, user_data);
+  if (cif->flags & UNIX64_FLAG_CIF_INFO)
+    ffi_cif_info_leave (info, cif, FFI_CIF_INFO_CLOSURE, start);
+  FFI_PROBE2 (closure__return, cif, fun);
+
+  shape_promote (cif, rvalue);
+}
+
 #ifdef FFI_GO_CLOSURES
 
 extern void ffi_go_closure_unix64(void) FFI_HIDDEN;
@@ -147,6 +147,33 @@ typedef enum ffi_abi {
 # define FFI_NATIVE_RAW_API 1  /* x86 has native raw api support */
 #endif
 
+#if defined (X86_64) || (defined (__x86_64__) && defined (X86_DARWIN))
+/* ffi64.c can lower a cif into a call plan.  */
+# define FFI_TARGET_HAS_PLAN
+/* ffi64.c implements ffi_prep_typed_closure_loc.  */
+# define FFI_TARGET_HAS_TYPED_CLOSURE
+/* ffi64.c implements ffi_get_image_layout and ffi_call_image.  */
+# define FFI_TARGET_HAS_CALL_IMAGE
+/* ffi64.c implements ffi_call_packed.  */
+# define FFI_TARGET_HAS_CALL_PACKED
+/* ffi64.c implements ffi_prep_packed_closure_loc.  */
+# define FFI_TARGET_HAS_PACKED_CLOSURE
+/* ffi64.c can prepare variadic cifs from a prepared fixed part.  */
+# define FFI_TARGET_HAS_VAR_TAIL
+/* ffi64.c can make calls on a caller-supplied stack.  */
+# define FFI_TARGET_HAS_CALL_ON_STACK
+/* ffi64.c consults the per-cif state of cifinfo.c for marked cifs.  */
+# define FFI_TARGET_HAS_CIF_INFO
+/* ffi64.c swaps errno right around the call in ffi_call_errno.  */
+# define FFI_TARGET_HAS_CALL_ERRNO
+/* ffi64.c describes the frames of closure trampolines for closures.c.  */
+# ifndef __ILP32__
+#  define FFI_TARGET_HAS_EXEC_CFI
+# endif
+/* ffi64.c reports calls and closure invocations to record.c.  */
+# define FFI_TARGET_HAS_RECORD
+#endif
+
 #if !defined(GENERATE_LIBFFI_MAP) && defined(__ASSEMBLER__) \
     && defined(__CET__)
 # include <cet.h>
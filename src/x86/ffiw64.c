@@ -237,6 +237,7 @@ EFI64(ffi_prep_closure_loc)(ffi_closure* closure,
   closure->cif = cif;
   closure->fun = fun;
   closure->user_data = user_data;
+  ffi_perf_map_closure (codeloc, FFI_TRAMPOLINE_SIZE, cif, (void *) fun);
 
   return FFI_OK;
 }
@@ -17,6 +17,12 @@
 
 #define UNIX64_RET_LAST		15
 
+/* The cif can be called through one of the precompiled register-shape
+   routines in ffi64.c; the shape is stored in place of the size.  */
+#define UNIX64_FLAG_REG_SHAPE	(1 << 9)
+/* The cif has state in the side table of cifinfo.c, such as hooks, so
+   its calls and closures take a slower path that looks it up.  */
+#define UNIX64_FLAG_CIF_INFO	(1 << 8)
 #define UNIX64_FLAG_RET_IN_MEM	(1 << 10)
 #define UNIX64_FLAG_XMM_ARGS	(1 << 11)
 #define UNIX64_SIZE_SHIFT	12
@@ -62,6 +62,33 @@ int _fprintf(FILE *stream, const char *format, ...)
 #endif
 /* --------------------------------------------------------------- */
 
+/* Benchmark mode ------------------------------------------------- */
+#ifdef BENCH
+/* Time each direct call and the same call through ffi_call, with the
+   harness in bench/.  The tracing in testcases.c would dominate the
+   timings; reduce it to a side effect that keeps the calls alive.  */
+#include "bench.h"
+static const char *bench_group;
+#define BENCH_TIMED(variant,stmt) \
+  do { if (bench_selected(bench_group)) BENCH_LOOP(bench_group,variant,stmt); \
+       else { stmt; } } while (0)
+#define BENCH_DIRECT(name,stmt) \
+  do { bench_group = #name; BENCH_TIMED("direct",stmt); } while (0)
+#define fprintf(...) ((void) bench_sink++)
+#define fflush(stream) ((void) 0)
+int bench_main (void);
+int (main) (int argc, char **argv)
+{
+  if (bench_init (argc, argv, NULL))
+    return 2;
+  return bench_main ();
+}
+#define main bench_main
+#else
+#define BENCH_DIRECT(name,stmt) stmt
+#endif
+/* --------------------------------------------------------------- */
+
 #include "testcases.c"
 
 #ifndef ABI_NUM
@@ -80,8 +107,13 @@ static ffi_type ffi_type_char;
   if (ffi_prep_cif(&(cif),ABI_NUM,sizeof(argtypes)/sizeof(argtypes[0]),&rettype,argtypes) != FFI_OK) abort()
 #define FFI_PREP_CIF_NOARGS(cif,rettype) \
   if (ffi_prep_cif(&(cif),ABI_NUM,0,&rettype,NULL) != FFI_OK) abort()
+#ifdef BENCH
+#define FFI_CALL(cif,fn,args,retaddr) \
+  BENCH_TIMED("ffi_call",ffi_call(&(cif),(void(*)(void))(fn),retaddr,args))
+#else
 #define FFI_CALL(cif,fn,args,retaddr) \
   ffi_call(&(cif),(void(*)(void))(fn),retaddr,args)
+#endif
 
 long clear_traces_i (long a, long b, long c, long d, long e, long f, long g, long h,
                      long i, long j, long k, long l, long m, long n, long o, long p)
@@ -107,7 +139,7 @@ void
   void_tests (void)
 {
 #if (!defined(DGTEST)) || DGTEST == 1  
-  v_v();
+  BENCH_DIRECT(v_v, v_v());
   clear_traces();
   {
     ffi_cif cif;
@@ -125,7 +157,7 @@ void
   int ir;
   ffi_arg retvalue;
 #if (!defined(DGTEST)) || DGTEST == 2
-  ir = i_v();
+  BENCH_DIRECT(i_v, ir = i_v());
   fprintf(out,"->%d\n",ir);
   fflush(out);
   ir = 0; clear_traces();
@@ -142,7 +174,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 3
-  ir = i_i(i1);
+  BENCH_DIRECT(i_i, ir = i_i(i1));
   fprintf(out,"->%d\n",ir);
   fflush(out);
   ir = 0; clear_traces();
@@ -161,7 +193,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 4
-  ir = i_i2(i1,i2);
+  BENCH_DIRECT(i_i2, ir = i_i2(i1,i2));
   fprintf(out,"->%d\n",ir);
   fflush(out);
   ir = 0; clear_traces();
@@ -180,7 +212,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 5
-  ir = i_i4(i1,i2,i3,i4);
+  BENCH_DIRECT(i_i4, ir = i_i4(i1,i2,i3,i4));
   fprintf(out,"->%d\n",ir);
   fflush(out);
   ir = 0; clear_traces();
@@ -199,7 +231,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 6
-  ir = i_i8(i1,i2,i3,i4,i5,i6,i7,i8);
+  BENCH_DIRECT(i_i8, ir = i_i8(i1,i2,i3,i4,i5,i6,i7,i8));
   fprintf(out,"->%d\n",ir);
   fflush(out);
   ir = 0; clear_traces();
@@ -218,7 +250,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 7
-  ir = i_i16(i1,i2,i3,i4,i5,i6,i7,i8,i9,i10,i11,i12,i13,i14,i15,i16);
+  BENCH_DIRECT(i_i16, ir = i_i16(i1,i2,i3,i4,i5,i6,i7,i8,i9,i10,i11,i12,i13,i14,i15,i16));
   fprintf(out,"->%d\n",ir);
   fflush(out);
   ir = 0; clear_traces();
@@ -244,7 +276,7 @@ void
   float fr;
 
 #if (!defined(DGTEST)) || DGTEST == 8
-  fr = f_f(f1);
+  BENCH_DIRECT(f_f, fr = f_f(f1));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -262,7 +294,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 9
-  fr = f_f2(f1,f2);
+  BENCH_DIRECT(f_f2, fr = f_f2(f1,f2));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -280,7 +312,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 10
-  fr = f_f4(f1,f2,f3,f4);
+  BENCH_DIRECT(f_f4, fr = f_f4(f1,f2,f3,f4));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -298,7 +330,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 11
-  fr = f_f8(f1,f2,f3,f4,f5,f6,f7,f8);
+  BENCH_DIRECT(f_f8, fr = f_f8(f1,f2,f3,f4,f5,f6,f7,f8));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -316,7 +348,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 12
-  fr = f_f16(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16);
+  BENCH_DIRECT(f_f16, fr = f_f16(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -334,7 +366,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 13
-  fr = f_f24(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,f18,f19,f20,f21,f22,f23,f24);
+  BENCH_DIRECT(f_f24, fr = f_f24(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,f18,f19,f20,f21,f22,f23,f24));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -358,7 +390,7 @@ void
 
 #if (!defined(DGTEST)) || DGTEST == 14
   
-  dr = d_d(d1);
+  BENCH_DIRECT(d_d, dr = d_d(d1));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -376,7 +408,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 15
-  dr = d_d2(d1,d2);
+  BENCH_DIRECT(d_d2, dr = d_d2(d1,d2));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -394,7 +426,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 16
-  dr = d_d4(d1,d2,d3,d4);
+  BENCH_DIRECT(d_d4, dr = d_d4(d1,d2,d3,d4));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -412,7 +444,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 17
-  dr = d_d8(d1,d2,d3,d4,d5,d6,d7,d8);
+  BENCH_DIRECT(d_d8, dr = d_d8(d1,d2,d3,d4,d5,d6,d7,d8));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -430,7 +462,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 18
-  dr = d_d16(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,d14,d15,d16);
+  BENCH_DIRECT(d_d16, dr = d_d16(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,d14,d15,d16));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -454,7 +486,7 @@ void
   void* vpr;
 
 #if (!defined(DGTEST)) || DGTEST == 19
-  vpr = vp_vpdpcpsp(&uc1,&d2,str3,&I4);
+  BENCH_DIRECT(vp_vpdpcpsp, vpr = vp_vpdpcpsp(&uc1,&d2,str3,&I4));
   fprintf(out,"->0x%p\n",vpr);
   fflush(out);
   vpr = 0; clear_traces();
@@ -488,7 +520,7 @@ void
   /* Unsigned types.
    */
 #if (!defined(DGTEST)) || DGTEST == 20
-  ucr = uc_ucsil(uc1, us2, ui3, ul4);
+  BENCH_DIRECT(uc_ucsil, ucr = uc_ucsil(uc1, us2, ui3, ul4));
   fprintf(out,"->%u\n",ucr);
   fflush(out);
   ucr = 0; clear_traces();
@@ -510,7 +542,7 @@ void
 #if (!defined(DGTEST)) || DGTEST == 21
   /* Mixed int & float types.
    */
-  dr = d_iidd(i1,i2,d3,d4);
+  BENCH_DIRECT(d_iidd, dr = d_iidd(i1,i2,d3,d4));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -528,7 +560,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 22
-  dr = d_iiidi(i1,i2,i3,d4,i5);
+  BENCH_DIRECT(d_iiidi, dr = d_iiidi(i1,i2,i3,d4,i5));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -546,7 +578,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 23
-  dr = d_idid(i1,d2,i3,d4);
+  BENCH_DIRECT(d_idid, dr = d_idid(i1,d2,i3,d4));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -564,7 +596,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 24
-  dr = d_fdi(f1,d2,i3);
+  BENCH_DIRECT(d_fdi, dr = d_fdi(f1,d2,i3));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -582,7 +614,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 25
-  usr = us_cdcd(c1,d2,c3,d4);
+  BENCH_DIRECT(us_cdcd, usr = us_cdcd(c1,d2,c3,d4));
   fprintf(out,"->%u\n",usr);
   fflush(out);
   usr = 0; clear_traces();
@@ -604,7 +636,7 @@ void
 #if (!defined(DGTEST)) || DGTEST == 26
   /* Long long types.
    */
-  llr = ll_iiilli(i1,i2,i3,ll1,i13);
+  BENCH_DIRECT(ll_iiilli, llr = ll_iiilli(i1,i2,i3,ll1,i13));
   fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
   fflush(out);
   llr = 0; clear_traces();
@@ -622,7 +654,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 27
-  llr = ll_flli(f13,ll1,i13);
+  BENCH_DIRECT(ll_flli, llr = ll_flli(f13,ll1,i13));
   fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
   fflush(out);
   llr = 0; clear_traces();
@@ -640,7 +672,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 28
-  fr = f_fi(f1,i9);
+  BENCH_DIRECT(f_fi, fr = f_fi(f1,i9));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -658,7 +690,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 29
-  fr = f_f2i(f1,f2,i9);
+  BENCH_DIRECT(f_f2i, fr = f_f2i(f1,f2,i9));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -676,7 +708,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 30
-  fr = f_f3i(f1,f2,f3,i9);
+  BENCH_DIRECT(f_f3i, fr = f_f3i(f1,f2,f3,i9));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -694,7 +726,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 31
-  fr = f_f4i(f1,f2,f3,f4,i9);
+  BENCH_DIRECT(f_f4i, fr = f_f4i(f1,f2,f3,f4,i9));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -712,7 +744,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 32
-  fr = f_f7i(f1,f2,f3,f4,f5,f6,f7,i9);
+  BENCH_DIRECT(f_f7i, fr = f_f7i(f1,f2,f3,f4,f5,f6,f7,i9));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -730,7 +762,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 33
-  fr = f_f8i(f1,f2,f3,f4,f5,f6,f7,f8,i9);
+  BENCH_DIRECT(f_f8i, fr = f_f8i(f1,f2,f3,f4,f5,f6,f7,f8,i9));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -748,7 +780,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 34
-  fr = f_f12i(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,i9);
+  BENCH_DIRECT(f_f12i, fr = f_f12i(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,i9));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -766,7 +798,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 35
-  fr = f_f13i(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,i9);
+  BENCH_DIRECT(f_f13i, fr = f_f13i(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,i9));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -784,7 +816,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 36
-  dr = d_di(d1,i9);
+  BENCH_DIRECT(d_di, dr = d_di(d1,i9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -802,7 +834,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 37
-  dr = d_d2i(d1,d2,i9);
+  BENCH_DIRECT(d_d2i, dr = d_d2i(d1,d2,i9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -820,7 +852,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 38
-  dr = d_d3i(d1,d2,d3,i9);
+  BENCH_DIRECT(d_d3i, dr = d_d3i(d1,d2,d3,i9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -838,7 +870,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 39
-  dr = d_d4i(d1,d2,d3,d4,i9);
+  BENCH_DIRECT(d_d4i, dr = d_d4i(d1,d2,d3,d4,i9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -856,7 +888,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 40
-  dr = d_d7i(d1,d2,d3,d4,d5,d6,d7,i9);
+  BENCH_DIRECT(d_d7i, dr = d_d7i(d1,d2,d3,d4,d5,d6,d7,i9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -874,7 +906,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 41
-  dr = d_d8i(d1,d2,d3,d4,d5,d6,d7,d8,i9);
+  BENCH_DIRECT(d_d8i, dr = d_d8i(d1,d2,d3,d4,d5,d6,d7,d8,i9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -892,7 +924,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 42
-  dr = d_d12i(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,i9);
+  BENCH_DIRECT(d_d12i, dr = d_d12i(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,i9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -910,7 +942,7 @@ void
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 43
-  dr = d_d13i(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,i9);
+  BENCH_DIRECT(d_d13i, dr = d_d13i(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,i9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -933,7 +965,8 @@ void
 {
 #if (!defined(DGTEST)) || DGTEST == 44
   {
-    Size1 r = S1_v();
+    Size1 r;
+    BENCH_DIRECT(S1_v, r = S1_v());
     fprintf(out,"->{%c}\n",r.x1);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -956,7 +989,8 @@ void
 #endif
 #if (!defined(DGTEST)) || DGTEST == 45
   {
-    Size2 r = S2_v();
+    Size2 r;
+    BENCH_DIRECT(S2_v, r = S2_v());
     fprintf(out,"->{%c%c}\n",r.x1,r.x2);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -979,7 +1013,8 @@ void
 #endif
 #if (!defined(DGTEST)) || DGTEST == 46
   {
-    Size3 r = S3_v();
+    Size3 r;
+    BENCH_DIRECT(S3_v, r = S3_v());
     fprintf(out,"->{%c%c%c}\n",r.x1,r.x2,r.x3);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -1002,7 +1037,8 @@ void
 #endif
 #if (!defined(DGTEST)) || DGTEST == 47
   {
-    Size4 r = S4_v();
+    Size4 r;
+    BENCH_DIRECT(S4_v, r = S4_v());
     fprintf(out,"->{%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -1025,7 +1061,8 @@ void
 #endif
 #if (!defined(DGTEST)) || DGTEST == 48
   {
-    Size7 r = S7_v();
+    Size7 r;
+    BENCH_DIRECT(S7_v, r = S7_v());
     fprintf(out,"->{%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -1048,7 +1085,8 @@ void
 #endif
 #if (!defined(DGTEST)) || DGTEST == 49
   {
-    Size8 r = S8_v();
+    Size8 r;
+    BENCH_DIRECT(S8_v, r = S8_v());
     fprintf(out,"->{%c%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7,r.x8);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -1071,7 +1109,8 @@ void
 #endif
 #if (!defined(DGTEST)) || DGTEST == 50
   {
-    Size12 r = S12_v();
+    Size12 r;
+    BENCH_DIRECT(S12_v, r = S12_v());
     fprintf(out,"->{%c%c%c%c%c%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7,r.x8,r.x9,r.x10,r.x11,r.x12);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -1094,7 +1133,8 @@ void
 #endif
 #if (!defined(DGTEST)) || DGTEST == 51  
   {
-    Size15 r = S15_v();
+    Size15 r;
+    BENCH_DIRECT(S15_v, r = S15_v());
     fprintf(out,"->{%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7,r.x8,r.x9,r.x10,r.x11,r.x12,r.x13,r.x14,r.x15);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -1117,7 +1157,8 @@ void
 #endif
 #if (!defined(DGTEST)) || DGTEST == 52  
   {
-    Size16 r = S16_v();
+    Size16 r;
+    BENCH_DIRECT(S16_v, r = S16_v());
     fprintf(out,"->{%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7,r.x8,r.x9,r.x10,r.x11,r.x12,r.x13,r.x14,r.x15,r.x16);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -1153,7 +1194,7 @@ void
 #endif  
 
 #if (!defined(DGTEST)) || DGTEST == 53  
-  Ir = I_III(I1,I2,I3);
+  BENCH_DIRECT(I_III, Ir = I_III(I1,I2,I3));
   fprintf(out,"->{%d}\n",Ir.x);
   fflush(out);
   Ir.x = 0; clear_traces();
@@ -1176,7 +1217,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 54
-  Cr = C_CdC(C1,d2,C3);
+  BENCH_DIRECT(C_CdC, Cr = C_CdC(C1,d2,C3));
   fprintf(out,"->{'%c'}\n",Cr.x);
   fflush(out);
   Cr.x = '\0'; clear_traces();
@@ -1199,7 +1240,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 55
-  Fr = F_Ffd(F1,f2,d3);
+  BENCH_DIRECT(F_Ffd, Fr = F_Ffd(F1,f2,d3));
   fprintf(out,"->{%g}\n",Fr.x);
   fflush(out);
   Fr.x = 0.0; clear_traces();
@@ -1222,7 +1263,7 @@ void
   fflush(out);
 #endif  
 #if (!defined(DGTEST)) || DGTEST == 56  
-  Dr = D_fDd(f1,D2,d3);
+  BENCH_DIRECT(D_fDd, Dr = D_fDd(f1,D2,d3));
   fprintf(out,"->{%g}\n",Dr.x);
   fflush(out);
   Dr.x = 0.0; clear_traces();
@@ -1245,7 +1286,7 @@ void
   fflush(out);
 #endif  
 #if (!defined(DGTEST)) || DGTEST == 57  
-  Dr = D_Dfd(D1,f2,d3);
+  BENCH_DIRECT(D_Dfd, Dr = D_Dfd(D1,f2,d3));
   fprintf(out,"->{%g}\n",Dr.x);
   fflush(out);
   Dr.x = 0.0; clear_traces();
@@ -1268,7 +1309,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 58  
-  Jr = J_JiJ(J1,i2,J2);
+  BENCH_DIRECT(J_JiJ, Jr = J_JiJ(J1,i2,J2));
   fprintf(out,"->{%ld,%ld}\n",Jr.l1,Jr.l2);
   fflush(out);
   Jr.l1 = Jr.l2 = 0; clear_traces();
@@ -1292,7 +1333,7 @@ void
 #endif
 #ifndef SKIP_EXTRA_STRUCTS
 #if (!defined(DGTEST)) || DGTEST == 59
-  Tr = T_TcT(T1,' ',T2);
+  BENCH_DIRECT(T_TcT, Tr = T_TcT(T1,' ',T2));
   fprintf(out,"->{\"%c%c%c\"}\n",Tr.c[0],Tr.c[1],Tr.c[2]);
   fflush(out);
   Tr.c[0] = Tr.c[1] = Tr.c[2] = 0; clear_traces();
@@ -1316,7 +1357,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 60
-  Xr = X_BcdB(B1,c2,d3,B2);
+  BENCH_DIRECT(X_BcdB, Xr = X_BcdB(B1,c2,d3,B2));
   fprintf(out,"->{\"%s\",'%c'}\n",Xr.c,Xr.c1);
   fflush(out);
   Xr.c[0]=Xr.c1='\0'; clear_traces();
@@ -1366,7 +1407,7 @@ void
   ffi_type_L.elements = ffi_type_L_elements;
 
 #if (!defined(DGTEST)) || DGTEST == 61  
-  lr = l_l0K(K1,l9);
+  BENCH_DIRECT(l_l0K, lr = l_l0K(K1,l9));
   fprintf(out,"->%ld\n",lr);
   fflush(out);
   lr = 0; clear_traces();
@@ -1383,7 +1424,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 62  
-  lr = l_l1K(l1,K1,l9);
+  BENCH_DIRECT(l_l1K, lr = l_l1K(l1,K1,l9));
   fprintf(out,"->%ld\n",lr);
   fflush(out);
   lr = 0; clear_traces();
@@ -1400,7 +1441,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 63  
-  lr = l_l2K(l1,l2,K1,l9);
+  BENCH_DIRECT(l_l2K, lr = l_l2K(l1,l2,K1,l9));
   fprintf(out,"->%ld\n",lr);
   fflush(out);
   lr = 0; clear_traces();
@@ -1417,7 +1458,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 64  
-  lr = l_l3K(l1,l2,l3,K1,l9);
+  BENCH_DIRECT(l_l3K, lr = l_l3K(l1,l2,l3,K1,l9));
   fprintf(out,"->%ld\n",lr);
   fflush(out);
   lr = 0; clear_traces();
@@ -1434,7 +1475,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 65
-  lr = l_l4K(l1,l2,l3,l4,K1,l9);
+  BENCH_DIRECT(l_l4K, lr = l_l4K(l1,l2,l3,l4,K1,l9));
   fprintf(out,"->%ld\n",lr);
   fflush(out);
   lr = 0; clear_traces();
@@ -1451,7 +1492,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 66
-  lr = l_l5K(l1,l2,l3,l4,l5,K1,l9);
+  BENCH_DIRECT(l_l5K, lr = l_l5K(l1,l2,l3,l4,l5,K1,l9));
   fprintf(out,"->%ld\n",lr);
   fflush(out);
   lr = 0; clear_traces();
@@ -1468,7 +1509,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 67  
-  lr = l_l6K(l1,l2,l3,l4,l5,l6,K1,l9);
+  BENCH_DIRECT(l_l6K, lr = l_l6K(l1,l2,l3,l4,l5,l6,K1,l9));
   fprintf(out,"->%ld\n",lr);
   fflush(out);
   lr = 0; clear_traces();
@@ -1485,7 +1526,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 68  
-  fr = f_f17l3L(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,l6,l7,l8,L1);
+  BENCH_DIRECT(f_f17l3L, fr = f_f17l3L(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,l6,l7,l8,L1));
   fprintf(out,"->%g\n",fr);
   fflush(out);
   fr = 0.0; clear_traces();
@@ -1502,7 +1543,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 69  
-  dr = d_d17l3L(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,d14,d15,d16,d17,l6,l7,l8,L1);
+  BENCH_DIRECT(d_d17l3L, dr = d_d17l3L(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,d14,d15,d16,d17,l6,l7,l8,L1));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -1519,7 +1560,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 70  
-  llr = ll_l2ll(l1,l2,ll1,l9);
+  BENCH_DIRECT(ll_l2ll, llr = ll_l2ll(l1,l2,ll1,l9));
   fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
   fflush(out);
   llr = 0; clear_traces();
@@ -1536,7 +1577,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 71
-  llr = ll_l3ll(l1,l2,l3,ll1,l9);
+  BENCH_DIRECT(ll_l3ll, llr = ll_l3ll(l1,l2,l3,ll1,l9));
   fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
   fflush(out);
   llr = 0; clear_traces();
@@ -1553,7 +1594,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 72  
-  llr = ll_l4ll(l1,l2,l3,l4,ll1,l9);
+  BENCH_DIRECT(ll_l4ll, llr = ll_l4ll(l1,l2,l3,l4,ll1,l9));
   fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
   fflush(out);
   llr = 0; clear_traces();
@@ -1570,7 +1611,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 73  
-  llr = ll_l5ll(l1,l2,l3,l4,l5,ll1,l9);
+  BENCH_DIRECT(ll_l5ll, llr = ll_l5ll(l1,l2,l3,l4,l5,ll1,l9));
   fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
   fflush(out);
   llr = 0; clear_traces();
@@ -1587,7 +1628,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 74  
-  llr = ll_l6ll(l1,l2,l3,l4,l5,l6,ll1,l9);
+  BENCH_DIRECT(ll_l6ll, llr = ll_l6ll(l1,l2,l3,l4,l5,l6,ll1,l9));
   fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
   fflush(out);
   llr = 0; clear_traces();
@@ -1604,7 +1645,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 75  
-  llr = ll_l7ll(l1,l2,l3,l4,l5,l6,l7,ll1,l9);
+  BENCH_DIRECT(ll_l7ll, llr = ll_l7ll(l1,l2,l3,l4,l5,l6,l7,ll1,l9));
   fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
   fflush(out);
   llr = 0; clear_traces();
@@ -1621,7 +1662,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 76  
-  dr = d_l2d(l1,l2,d2,l9);
+  BENCH_DIRECT(d_l2d, dr = d_l2d(l1,l2,d2,l9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -1638,7 +1679,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 77  
-  dr = d_l3d(l1,l2,l3,d2,l9);
+  BENCH_DIRECT(d_l3d, dr = d_l3d(l1,l2,l3,d2,l9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -1655,7 +1696,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 78  
-  dr = d_l4d(l1,l2,l3,l4,d2,l9);
+  BENCH_DIRECT(d_l4d, dr = d_l4d(l1,l2,l3,l4,d2,l9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -1672,7 +1713,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 79  
-  dr = d_l5d(l1,l2,l3,l4,l5,d2,l9);
+  BENCH_DIRECT(d_l5d, dr = d_l5d(l1,l2,l3,l4,l5,d2,l9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -1689,7 +1730,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 80  
-  dr = d_l6d(l1,l2,l3,l4,l5,l6,d2,l9);
+  BENCH_DIRECT(d_l6d, dr = d_l6d(l1,l2,l3,l4,l5,l6,d2,l9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -1706,7 +1747,7 @@ void
   fflush(out);
 #endif
 #if (!defined(DGTEST)) || DGTEST == 81  
-  dr = d_l7d(l1,l2,l3,l4,l5,l6,l7,d2,l9);
+  BENCH_DIRECT(d_l7d, dr = d_l7d(l1,l2,l3,l4,l5,l6,l7,d2,l9));
   fprintf(out,"->%g\n",dr);
   fflush(out);
   dr = 0.0; clear_traces();
@@ -62,6 +62,35 @@ int _fprintf(FILE *stream, const char *format, ...)
 #endif
 /* --------------------------------------------------------------- */
 
+/* Benchmark mode ------------------------------------------------- */
+#ifdef BENCH
+/* Time each direct call and the same call through a closure, with the
+   harness in bench/.  The tracing in testcases.c would dominate the
+   timings; reduce it to a side effect that keeps the calls alive.  */
+#include "bench.h"
+static const char *bench_group;
+#define BENCH_TIMED(variant,stmt) \
+  do { if (bench_selected(bench_group)) BENCH_LOOP(bench_group,variant,stmt); \
+       else { stmt; } } while (0)
+#define BENCH_DIRECT(name,stmt) \
+  do { bench_group = #name; BENCH_TIMED("direct",stmt); } while (0)
+#define BENCH_CLOSURE(stmt) BENCH_TIMED("closure",stmt)
+#define fprintf(...) ((void) bench_sink++)
+#define fflush(stream) ((void) 0)
+int bench_main (void);
+int (main) (int argc, char **argv)
+{
+  if (bench_init (argc, argv, NULL))
+    return 2;
+  return bench_main ();
+}
+#define main bench_main
+#else
+#define BENCH_DIRECT(name,stmt) stmt
+#define BENCH_CLOSURE(stmt) stmt
+#endif
+/* --------------------------------------------------------------- */
+
 #include "testcases.c"
 
 #ifndef ABI_NUM
@@ -1269,14 +1298,14 @@ int main (void)
 
 #if (!defined(DGTEST)) || DGTEST == 1  
   /* void tests */
-  v_v();
+  BENCH_DIRECT(v_v, v_v());
   clear_traces();
   ALLOC_CALLBACK();
   {
     ffi_cif cif;
     FFI_PREP_CIF_NOARGS(cif,ffi_type_void);
     PREP_CALLBACK(cif,v_v_simulator,(void*)&v_v);
-    ((void (ABI_ATTR *) (void)) callback_code) ();
+    BENCH_CLOSURE(((void (ABI_ATTR *) (void)) callback_code) ());
   }
   FREE_CALLBACK();
 #endif
@@ -1285,7 +1314,7 @@ int main (void)
   { int ir;
 
 #if (!defined(DGTEST)) || DGTEST == 2
-    ir = i_v();
+    BENCH_DIRECT(i_v, ir = i_v());
     fprintf(out,"->%d\n",ir);
     fflush(out);
     ir = 0; clear_traces();
@@ -1294,7 +1323,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF_NOARGS(cif,ffi_type_sint);
       PREP_CALLBACK(cif,i_v_simulator,(void*)&i_v);
-      ir = ((int (ABI_ATTR *) (void)) callback_code) ();
+      BENCH_CLOSURE(ir = ((int (ABI_ATTR *) (void)) callback_code) ());
     }
     FREE_CALLBACK();
     fprintf(out,"->%d\n",ir);
@@ -1302,7 +1331,7 @@ int main (void)
 #endif    
 
 #if (!defined(DGTEST)) || DGTEST == 3
-    ir = i_i(i1);
+    BENCH_DIRECT(i_i, ir = i_i(i1));
     fprintf(out,"->%d\n",ir);
     fflush(out);
     ir = 0; clear_traces();
@@ -1312,7 +1341,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_sint);
       PREP_CALLBACK(cif,i_i_simulator,(void*)&i_i);
-      ir = ((int (ABI_ATTR *) (int)) callback_code) (i1);
+      BENCH_CLOSURE(ir = ((int (ABI_ATTR *) (int)) callback_code) (i1));
     }
     FREE_CALLBACK();
     fprintf(out,"->%d\n",ir);
@@ -1320,7 +1349,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 4    
-    ir = i_i2(i1,i2);
+    BENCH_DIRECT(i_i2, ir = i_i2(i1,i2));
     fprintf(out,"->%d\n",ir);
     fflush(out);
     ir = 0; clear_traces();
@@ -1330,7 +1359,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_sint);
       PREP_CALLBACK(cif,i_i2_simulator,(void*)&i_i2);
-      ir = ((int (ABI_ATTR *) (int,int)) callback_code) (i1,i2);
+      BENCH_CLOSURE(ir = ((int (ABI_ATTR *) (int,int)) callback_code) (i1,i2));
     }
     FREE_CALLBACK();
     fprintf(out,"->%d\n",ir);
@@ -1338,7 +1367,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 5    
-    ir = i_i4(i1,i2,i3,i4);
+    BENCH_DIRECT(i_i4, ir = i_i4(i1,i2,i3,i4));
     fprintf(out,"->%d\n",ir);
     fflush(out);
     ir = 0; clear_traces();
@@ -1348,7 +1377,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_sint);
       PREP_CALLBACK(cif,i_i4_simulator,(void*)&i_i4);
-      ir = ((int (ABI_ATTR *) (int,int,int,int)) callback_code) (i1,i2,i3,i4);
+      BENCH_CLOSURE(ir = ((int (ABI_ATTR *) (int,int,int,int)) callback_code) (i1,i2,i3,i4));
     }
     FREE_CALLBACK();
     fprintf(out,"->%d\n",ir);
@@ -1356,7 +1385,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 6    
-    ir = i_i8(i1,i2,i3,i4,i5,i6,i7,i8);
+    BENCH_DIRECT(i_i8, ir = i_i8(i1,i2,i3,i4,i5,i6,i7,i8));
     fprintf(out,"->%d\n",ir);
     fflush(out);
     ir = 0; clear_traces();
@@ -1366,7 +1395,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_sint);
       PREP_CALLBACK(cif,i_i8_simulator,(void*)&i_i8);
-      ir = ((int (ABI_ATTR *) (int,int,int,int,int,int,int,int)) callback_code) (i1,i2,i3,i4,i5,i6,i7,i8);
+      BENCH_CLOSURE(ir = ((int (ABI_ATTR *) (int,int,int,int,int,int,int,int)) callback_code) (i1,i2,i3,i4,i5,i6,i7,i8));
     }
     FREE_CALLBACK();
     fprintf(out,"->%d\n",ir);
@@ -1374,7 +1403,7 @@ int main (void)
 #endif
   
 #if (!defined(DGTEST)) || DGTEST == 7
-    ir = i_i16(i1,i2,i3,i4,i5,i6,i7,i8,i9,i10,i11,i12,i13,i14,i15,i16);
+    BENCH_DIRECT(i_i16, ir = i_i16(i1,i2,i3,i4,i5,i6,i7,i8,i9,i10,i11,i12,i13,i14,i15,i16));
     fprintf(out,"->%d\n",ir);
     fflush(out);
     ir = 0; clear_traces();
@@ -1384,7 +1413,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_sint);
       PREP_CALLBACK(cif,i_i16_simulator,(void*)&i_i16);
-      ir = ((int (ABI_ATTR *) (int,int,int,int,int,int,int,int,int,int,int,int,int,int,int,int)) callback_code) (i1,i2,i3,i4,i5,i6,i7,i8,i9,i10,i11,i12,i13,i14,i15,i16);
+      BENCH_CLOSURE(ir = ((int (ABI_ATTR *) (int,int,int,int,int,int,int,int,int,int,int,int,int,int,int,int)) callback_code) (i1,i2,i3,i4,i5,i6,i7,i8,i9,i10,i11,i12,i13,i14,i15,i16));
     }
     FREE_CALLBACK();
     fprintf(out,"->%d\n",ir);
@@ -1396,7 +1425,7 @@ int main (void)
   { float fr;
 
 #if (!defined(DGTEST)) || DGTEST == 8  
-    fr = f_f(f1);
+    BENCH_DIRECT(f_f, fr = f_f(f1));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1406,7 +1435,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f_simulator,(void*)&f_f);
-      fr = ((float (ABI_ATTR *) (float)) callback_code) (f1);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float)) callback_code) (f1));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1414,7 +1443,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 9    
-    fr = f_f2(f1,f2);
+    BENCH_DIRECT(f_f2, fr = f_f2(f1,f2));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1424,7 +1453,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f2_simulator,(void*)&f_f2);
-      fr = ((float (ABI_ATTR *) (float,float)) callback_code) (f1,f2);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,float)) callback_code) (f1,f2));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1432,7 +1461,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 10
-    fr = f_f4(f1,f2,f3,f4);
+    BENCH_DIRECT(f_f4, fr = f_f4(f1,f2,f3,f4));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1442,7 +1471,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f4_simulator,(void*)&f_f4);
-      fr = ((float (ABI_ATTR *) (float,float,float,float)) callback_code) (f1,f2,f3,f4);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,float,float,float)) callback_code) (f1,f2,f3,f4));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1450,7 +1479,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 11    
-    fr = f_f8(f1,f2,f3,f4,f5,f6,f7,f8);
+    BENCH_DIRECT(f_f8, fr = f_f8(f1,f2,f3,f4,f5,f6,f7,f8));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1460,7 +1489,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f8_simulator,(void*)&f_f8);
-      fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,float)) callback_code) (f1,f2,f3,f4,f5,f6,f7,f8);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,float)) callback_code) (f1,f2,f3,f4,f5,f6,f7,f8));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1468,7 +1497,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 12    
-    fr = f_f16(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16);
+    BENCH_DIRECT(f_f16, fr = f_f16(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1478,7 +1507,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f16_simulator,(void*)&f_f16);
-      fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float)) callback_code) (f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float)) callback_code) (f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1486,7 +1515,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 13    
-    fr = f_f24(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,f18,f19,f20,f21,f22,f23,f24);
+    BENCH_DIRECT(f_f24, fr = f_f24(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,f18,f19,f20,f21,f22,f23,f24));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1496,7 +1525,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f24_simulator,(void*)&f_f24);
-      fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float)) callback_code) (f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,f18,f19,f20,f21,f22,f23,f24);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float)) callback_code) (f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,f18,f19,f20,f21,f22,f23,f24));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1509,7 +1538,7 @@ int main (void)
   { double dr;
 
 #if (!defined(DGTEST)) || DGTEST == 14
-    dr = d_d(d1);
+    BENCH_DIRECT(d_d, dr = d_d(d1));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1519,7 +1548,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d_simulator,(void*)&d_d);
-      dr = ((double (ABI_ATTR *) (double)) callback_code) (d1);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double)) callback_code) (d1));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1527,7 +1556,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 15    
-    dr = d_d2(d1,d2);
+    BENCH_DIRECT(d_d2, dr = d_d2(d1,d2));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1537,7 +1566,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d2_simulator,(void*)&d_d2);
-      dr = ((double (ABI_ATTR *) (double,double)) callback_code) (d1,d2);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,double)) callback_code) (d1,d2));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1545,7 +1574,7 @@ int main (void)
 #endif
   
 #if (!defined(DGTEST)) || DGTEST == 16    
-    dr = d_d4(d1,d2,d3,d4);
+    BENCH_DIRECT(d_d4, dr = d_d4(d1,d2,d3,d4));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1555,7 +1584,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d4_simulator,(void*)&d_d4);
-      dr = ((double (ABI_ATTR *) (double,double,double,double)) callback_code) (d1,d2,d3,d4);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,double,double,double)) callback_code) (d1,d2,d3,d4));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1563,7 +1592,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 17    
-    dr = d_d8(d1,d2,d3,d4,d5,d6,d7,d8);
+    BENCH_DIRECT(d_d8, dr = d_d8(d1,d2,d3,d4,d5,d6,d7,d8));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1573,7 +1602,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d8_simulator,(void*)&d_d8);
-      dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,double)) callback_code) (d1,d2,d3,d4,d5,d6,d7,d8);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,double)) callback_code) (d1,d2,d3,d4,d5,d6,d7,d8));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1581,7 +1610,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 18    
-    dr = d_d16(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,d14,d15,d16);
+    BENCH_DIRECT(d_d16, dr = d_d16(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,d14,d15,d16));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1591,7 +1620,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d16_simulator,(void*)&d_d16);
-      dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,double,double,double,double,double,double,double,double,double)) callback_code) (d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,d14,d15,d16);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,double,double,double,double,double,double,double,double,double)) callback_code) (d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,d14,d15,d16));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1603,7 +1632,7 @@ int main (void)
   { void* vpr;
 
 #if (!defined(DGTEST)) || DGTEST == 19 
-    vpr = vp_vpdpcpsp(&uc1,&d2,str3,&I4);
+    BENCH_DIRECT(vp_vpdpcpsp, vpr = vp_vpdpcpsp(&uc1,&d2,str3,&I4));
     fprintf(out,"->0x%p\n",vpr);
     fflush(out);
     vpr = 0; clear_traces();
@@ -1613,7 +1642,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_pointer);
       PREP_CALLBACK(cif,vp_vpdpcpsp_simulator,(void*)&vp_vpdpcpsp);
-      vpr = ((void* (ABI_ATTR *) (void*,double*,char*,Int*)) callback_code) (&uc1,&d2,str3,&I4);
+      BENCH_CLOSURE(vpr = ((void* (ABI_ATTR *) (void*,double*,char*,Int*)) callback_code) (&uc1,&d2,str3,&I4));
     }
     FREE_CALLBACK();
     fprintf(out,"->0x%p\n",vpr);
@@ -1629,7 +1658,7 @@ int main (void)
     long long llr;
 
 #if (!defined(DGTEST)) || DGTEST == 20
-    ucr = uc_ucsil(uc1,us2,ui3,ul4);
+    BENCH_DIRECT(uc_ucsil, ucr = uc_ucsil(uc1,us2,ui3,ul4));
     fprintf(out,"->%u\n",ucr);
     fflush(out);
     ucr = 0; clear_traces();
@@ -1639,7 +1668,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_uchar);
       PREP_CALLBACK(cif,uc_ucsil_simulator,(void*)&uc_ucsil);
-      ucr = ((uchar (ABI_ATTR *) (uchar,ushort,uint,ulong)) callback_code) (uc1,us2,ui3,ul4);
+      BENCH_CLOSURE(ucr = ((uchar (ABI_ATTR *) (uchar,ushort,uint,ulong)) callback_code) (uc1,us2,ui3,ul4));
     }
     FREE_CALLBACK();
     fprintf(out,"->%u\n",ucr);
@@ -1647,7 +1676,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 21    
-    dr = d_iidd(i1,i2,d3,d4);
+    BENCH_DIRECT(d_iidd, dr = d_iidd(i1,i2,d3,d4));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1657,7 +1686,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_iidd_simulator,(void*)&d_iidd);
-      dr = ((double (ABI_ATTR *) (int,int,double,double)) callback_code) (i1,i2,d3,d4);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (int,int,double,double)) callback_code) (i1,i2,d3,d4));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1665,7 +1694,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 22    
-    dr = d_iiidi(i1,i2,i3,d4,i5);
+    BENCH_DIRECT(d_iiidi, dr = d_iiidi(i1,i2,i3,d4,i5));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1675,7 +1704,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_iiidi_simulator,(void*)&d_iiidi);
-      dr = ((double (ABI_ATTR *) (int,int,int,double,int)) callback_code) (i1,i2,i3,d4,i5);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (int,int,int,double,int)) callback_code) (i1,i2,i3,d4,i5));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1683,7 +1712,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 23    
-    dr = d_idid(i1,d2,i3,d4);
+    BENCH_DIRECT(d_idid, dr = d_idid(i1,d2,i3,d4));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1693,7 +1722,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_idid_simulator,(void*)&d_idid);
-      dr = ((double (ABI_ATTR *) (int,double,int,double)) callback_code) (i1,d2,i3,d4);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (int,double,int,double)) callback_code) (i1,d2,i3,d4));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1701,7 +1730,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 24    
-    dr = d_fdi(f1,d2,i3);
+    BENCH_DIRECT(d_fdi, dr = d_fdi(f1,d2,i3));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1711,7 +1740,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_fdi_simulator,(void*)&d_fdi);
-      dr = ((double (ABI_ATTR *) (float,double,int)) callback_code) (f1,d2,i3);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (float,double,int)) callback_code) (f1,d2,i3));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1719,7 +1748,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 25    
-    usr = us_cdcd(c1,d2,c3,d4);
+    BENCH_DIRECT(us_cdcd, usr = us_cdcd(c1,d2,c3,d4));
     fprintf(out,"->%u\n",usr);
     fflush(out);
     usr = 0; clear_traces();
@@ -1729,7 +1758,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_ushort);
       PREP_CALLBACK(cif,us_cdcd_simulator,(void*)&us_cdcd);
-      usr = ((ushort (ABI_ATTR *) (char,double,char,double)) callback_code) (c1,d2,c3,d4);
+      BENCH_CLOSURE(usr = ((ushort (ABI_ATTR *) (char,double,char,double)) callback_code) (c1,d2,c3,d4));
     }
     FREE_CALLBACK();
     fprintf(out,"->%u\n",usr);
@@ -1737,7 +1766,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 26    
-    llr = ll_iiilli(i1,i2,i3,ll1,i13);
+    BENCH_DIRECT(ll_iiilli, llr = ll_iiilli(i1,i2,i3,ll1,i13));
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
     fflush(out);
     llr = 0; clear_traces();
@@ -1747,7 +1776,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slonglong);
       PREP_CALLBACK(cif,ll_iiilli_simulator,(void*)&ll_iiilli);
-      llr = ((long long (ABI_ATTR *) (int,int,int,long long,int)) callback_code) (i1,i2,i3,ll1,i13);
+      BENCH_CLOSURE(llr = ((long long (ABI_ATTR *) (int,int,int,long long,int)) callback_code) (i1,i2,i3,ll1,i13));
     }
     FREE_CALLBACK();
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
@@ -1755,7 +1784,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 27    
-    llr = ll_flli(f13,ll1,i13);
+    BENCH_DIRECT(ll_flli, llr = ll_flli(f13,ll1,i13));
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
     fflush(out);
     llr = 0; clear_traces();
@@ -1765,7 +1794,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slonglong);
       PREP_CALLBACK(cif,ll_flli_simulator,(void*)&ll_flli);
-      llr = ((long long (ABI_ATTR *) (float,long long,int)) callback_code) (f13,ll1,i13);
+      BENCH_CLOSURE(llr = ((long long (ABI_ATTR *) (float,long long,int)) callback_code) (f13,ll1,i13));
     }
     FREE_CALLBACK();
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
@@ -1773,7 +1802,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 28    
-    fr = f_fi(f1,i9);
+    BENCH_DIRECT(f_fi, fr = f_fi(f1,i9));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1783,7 +1812,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_fi_simulator,(void*)&f_fi);
-      fr = ((float (ABI_ATTR *) (float,int)) callback_code) (f1,i9);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,int)) callback_code) (f1,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1791,7 +1820,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 29    
-    fr = f_f2i(f1,f2,i9);
+    BENCH_DIRECT(f_f2i, fr = f_f2i(f1,f2,i9));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1801,7 +1830,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f2i_simulator,(void*)&f_f2i);
-      fr = ((float (ABI_ATTR *) (float,float,int)) callback_code) (f1,f2,i9);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,float,int)) callback_code) (f1,f2,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1809,7 +1838,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 30    
-    fr = f_f3i(f1,f2,f3,i9);
+    BENCH_DIRECT(f_f3i, fr = f_f3i(f1,f2,f3,i9));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1819,7 +1848,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f3i_simulator,(void*)&f_f3i);
-      fr = ((float (ABI_ATTR *) (float,float,float,int)) callback_code) (f1,f2,f3,i9);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,float,float,int)) callback_code) (f1,f2,f3,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1827,7 +1856,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 31    
-    fr = f_f4i(f1,f2,f3,f4,i9);
+    BENCH_DIRECT(f_f4i, fr = f_f4i(f1,f2,f3,f4,i9));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1837,7 +1866,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f4i_simulator,(void*)&f_f4i);
-      fr = ((float (ABI_ATTR *) (float,float,float,float,int)) callback_code) (f1,f2,f3,f4,i9);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,float,float,float,int)) callback_code) (f1,f2,f3,f4,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1845,7 +1874,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 32    
-    fr = f_f7i(f1,f2,f3,f4,f5,f6,f7,i9);
+    BENCH_DIRECT(f_f7i, fr = f_f7i(f1,f2,f3,f4,f5,f6,f7,i9));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1855,7 +1884,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f7i_simulator,(void*)&f_f7i);
-      fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,int)) callback_code) (f1,f2,f3,f4,f5,f6,f7,i9);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,int)) callback_code) (f1,f2,f3,f4,f5,f6,f7,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1863,7 +1892,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 33    
-    fr = f_f8i(f1,f2,f3,f4,f5,f6,f7,f8,i9);
+    BENCH_DIRECT(f_f8i, fr = f_f8i(f1,f2,f3,f4,f5,f6,f7,f8,i9));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1873,7 +1902,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f8i_simulator,(void*)&f_f8i);
-      fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,float,int)) callback_code) (f1,f2,f3,f4,f5,f6,f7,f8,i9);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,float,int)) callback_code) (f1,f2,f3,f4,f5,f6,f7,f8,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1881,7 +1910,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 34    
-    fr = f_f13i(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,i9);
+    BENCH_DIRECT(f_f13i, fr = f_f13i(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,i9));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -1891,7 +1920,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f13i_simulator,(void*)&f_f13i);
-      fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,float,float,float,float,float,float,int)) callback_code) (f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,i9);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,float,float,float,float,float,float,int)) callback_code) (f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -1899,7 +1928,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 35    
-    dr = d_di(d1,i9);
+    BENCH_DIRECT(d_di, dr = d_di(d1,i9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1909,7 +1938,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_di_simulator,(void*)&d_di);
-      dr = ((double (ABI_ATTR *) (double,int)) callback_code) (d1,i9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,int)) callback_code) (d1,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1917,7 +1946,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 36    
-    dr = d_d2i(d1,d2,i9);
+    BENCH_DIRECT(d_d2i, dr = d_d2i(d1,d2,i9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1927,7 +1956,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d2i_simulator,(void*)&d_d2i);
-      dr = ((double (ABI_ATTR *) (double,double,int)) callback_code) (d1,d2,i9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,double,int)) callback_code) (d1,d2,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1935,7 +1964,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 37    
-    dr = d_d3i(d1,d2,d3,i9);
+    BENCH_DIRECT(d_d3i, dr = d_d3i(d1,d2,d3,i9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1945,7 +1974,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d3i_simulator,(void*)&d_d3i);
-      dr = ((double (ABI_ATTR *) (double,double,double,int)) callback_code) (d1,d2,d3,i9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,double,double,int)) callback_code) (d1,d2,d3,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1953,7 +1982,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 38    
-    dr = d_d4i(d1,d2,d3,d4,i9);
+    BENCH_DIRECT(d_d4i, dr = d_d4i(d1,d2,d3,d4,i9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1963,7 +1992,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d4i_simulator,(void*)&d_d4i);
-      dr = ((double (ABI_ATTR *) (double,double,double,double,int)) callback_code) (d1,d2,d3,d4,i9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,double,double,double,int)) callback_code) (d1,d2,d3,d4,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1971,7 +2000,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 39    
-    dr = d_d7i(d1,d2,d3,d4,d5,d6,d7,i9);
+    BENCH_DIRECT(d_d7i, dr = d_d7i(d1,d2,d3,d4,d5,d6,d7,i9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1981,7 +2010,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d7i_simulator,(void*)&d_d7i);
-      dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,int)) callback_code) (d1,d2,d3,d4,d5,d6,d7,i9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,int)) callback_code) (d1,d2,d3,d4,d5,d6,d7,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -1989,7 +2018,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 40    
-    dr = d_d8i(d1,d2,d3,d4,d5,d6,d7,d8,i9);
+    BENCH_DIRECT(d_d8i, dr = d_d8i(d1,d2,d3,d4,d5,d6,d7,d8,i9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -1999,7 +2028,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d8i_simulator,(void*)&d_d8i);
-      dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,double,int)) callback_code) (d1,d2,d3,d4,d5,d6,d7,d8,i9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,double,int)) callback_code) (d1,d2,d3,d4,d5,d6,d7,d8,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -2007,7 +2036,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 41    
-    dr = d_d12i(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,i9);
+    BENCH_DIRECT(d_d12i, dr = d_d12i(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,i9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -2017,7 +2046,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d12i_simulator,(void*)&d_d12i);
-      dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,double,double,double,double,double,int)) callback_code) (d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,i9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,double,double,double,double,double,int)) callback_code) (d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -2025,7 +2054,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 42    
-    dr = d_d13i(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,i9);
+    BENCH_DIRECT(d_d13i, dr = d_d13i(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,i9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -2035,7 +2064,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d13i_simulator,(void*)&d_d13i);
-      dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,double,double,double,double,double,double,int)) callback_code) (d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,i9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,double,double,double,double,double,double,int)) callback_code) (d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,i9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -2046,7 +2075,8 @@ int main (void)
   /* small structure return tests */
 #if (!defined(DGTEST)) || DGTEST == 43
   {
-    Size1 r = S1_v();
+    Size1 r;
+    BENCH_DIRECT(S1_v, r = S1_v());
     fprintf(out,"->{%c}\n",r.x1);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -2061,7 +2091,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF_NOARGS(cif,ffi_type_Size1);
       PREP_CALLBACK(cif,S1_v_simulator,(void*)&S1_v);
-      r = ((Size1 (ABI_ATTR *) (void)) callback_code) ();
+      BENCH_CLOSURE(r = ((Size1 (ABI_ATTR *) (void)) callback_code) ());
     }
     FREE_CALLBACK();
     fprintf(out,"->{%c}\n",r.x1);
@@ -2071,7 +2101,8 @@ int main (void)
 
 #if (!defined(DGTEST)) || DGTEST == 44
   {
-    Size2 r = S2_v();
+    Size2 r;
+    BENCH_DIRECT(S2_v, r = S2_v());
     fprintf(out,"->{%c%c}\n",r.x1,r.x2);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -2086,7 +2117,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF_NOARGS(cif,ffi_type_Size2);
       PREP_CALLBACK(cif,S2_v_simulator,(void*)&S2_v);
-      r = ((Size2 (ABI_ATTR *) (void)) callback_code) ();
+      BENCH_CLOSURE(r = ((Size2 (ABI_ATTR *) (void)) callback_code) ());
     }
     FREE_CALLBACK();
     fprintf(out,"->{%c%c}\n",r.x1,r.x2);
@@ -2096,7 +2127,8 @@ int main (void)
 
 #if (!defined(DGTEST)) || DGTEST == 45
   {
-    Size3 r = S3_v();
+    Size3 r;
+    BENCH_DIRECT(S3_v, r = S3_v());
     fprintf(out,"->{%c%c%c}\n",r.x1,r.x2,r.x3);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -2111,7 +2143,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF_NOARGS(cif,ffi_type_Size3);
       PREP_CALLBACK(cif,S3_v_simulator,(void*)&S3_v);
-      r = ((Size3 (ABI_ATTR *) (void)) callback_code) ();
+      BENCH_CLOSURE(r = ((Size3 (ABI_ATTR *) (void)) callback_code) ());
     }
     FREE_CALLBACK();
     fprintf(out,"->{%c%c%c}\n",r.x1,r.x2,r.x3);
@@ -2121,7 +2153,8 @@ int main (void)
 
 #if (!defined(DGTEST)) || DGTEST == 46
   {
-    Size4 r = S4_v();
+    Size4 r;
+    BENCH_DIRECT(S4_v, r = S4_v());
     fprintf(out,"->{%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -2136,7 +2169,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF_NOARGS(cif,ffi_type_Size4);
       PREP_CALLBACK(cif,S4_v_simulator,(void*)&S4_v);
-      r = ((Size4 (ABI_ATTR *) (void)) callback_code) ();
+      BENCH_CLOSURE(r = ((Size4 (ABI_ATTR *) (void)) callback_code) ());
     }
     FREE_CALLBACK();
     fprintf(out,"->{%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4);
@@ -2146,7 +2179,8 @@ int main (void)
 
 #if (!defined(DGTEST)) || DGTEST == 47  
   {
-    Size7 r = S7_v();
+    Size7 r;
+    BENCH_DIRECT(S7_v, r = S7_v());
     fprintf(out,"->{%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -2161,7 +2195,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF_NOARGS(cif,ffi_type_Size7);
       PREP_CALLBACK(cif,S7_v_simulator,(void*)&S7_v);
-      r = ((Size7 (ABI_ATTR *) (void)) callback_code) ();
+      BENCH_CLOSURE(r = ((Size7 (ABI_ATTR *) (void)) callback_code) ());
     }
     FREE_CALLBACK();
     fprintf(out,"->{%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7);
@@ -2171,7 +2205,8 @@ int main (void)
 
 #if (!defined(DGTEST)) || DGTEST == 48  
   {
-    Size8 r = S8_v();
+    Size8 r;
+    BENCH_DIRECT(S8_v, r = S8_v());
     fprintf(out,"->{%c%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7,r.x8);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -2186,7 +2221,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF_NOARGS(cif,ffi_type_Size8);
       PREP_CALLBACK(cif,S8_v_simulator,(void*)&S8_v);
-      r = ((Size8 (ABI_ATTR *) (void)) callback_code) ();
+      BENCH_CLOSURE(r = ((Size8 (ABI_ATTR *) (void)) callback_code) ());
     }
     FREE_CALLBACK();
     fprintf(out,"->{%c%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7,r.x8);
@@ -2196,7 +2231,8 @@ int main (void)
 
 #if (!defined(DGTEST)) || DGTEST == 49
   {
-    Size12 r = S12_v();
+    Size12 r;
+    BENCH_DIRECT(S12_v, r = S12_v());
     fprintf(out,"->{%c%c%c%c%c%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7,r.x8,r.x9,r.x10,r.x11,r.x12);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -2211,7 +2247,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF_NOARGS(cif,ffi_type_Size12);
       PREP_CALLBACK(cif,S12_v_simulator,(void*)&S12_v);
-      r = ((Size12 (ABI_ATTR *) (void)) callback_code) ();
+      BENCH_CLOSURE(r = ((Size12 (ABI_ATTR *) (void)) callback_code) ());
     }
     FREE_CALLBACK();
     fprintf(out,"->{%c%c%c%c%c%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7,r.x8,r.x9,r.x10,r.x11,r.x12);
@@ -2221,7 +2257,8 @@ int main (void)
 
 #if (!defined(DGTEST)) || DGTEST == 50  
   {
-    Size15 r = S15_v();
+    Size15 r;
+    BENCH_DIRECT(S15_v, r = S15_v());
     fprintf(out,"->{%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7,r.x8,r.x9,r.x10,r.x11,r.x12,r.x13,r.x14,r.x15);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -2236,7 +2273,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF_NOARGS(cif,ffi_type_Size15);
       PREP_CALLBACK(cif,S15_v_simulator,(void*)&S15_v);
-      r = ((Size15 (ABI_ATTR *) (void)) callback_code) ();
+      BENCH_CLOSURE(r = ((Size15 (ABI_ATTR *) (void)) callback_code) ());
     }
     FREE_CALLBACK();
     fprintf(out,"->{%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7,r.x8,r.x9,r.x10,r.x11,r.x12,r.x13,r.x14,r.x15);
@@ -2246,7 +2283,8 @@ int main (void)
 
 #if (!defined(DGTEST)) || DGTEST == 51
   {
-    Size16 r = S16_v();
+    Size16 r;
+    BENCH_DIRECT(S16_v, r = S16_v());
     fprintf(out,"->{%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7,r.x8,r.x9,r.x10,r.x11,r.x12,r.x13,r.x14,r.x15,r.x16);
     fflush(out);
     memset(&r,0,sizeof(r)); clear_traces();
@@ -2261,7 +2299,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF_NOARGS(cif,ffi_type_Size16);
       PREP_CALLBACK(cif,S16_v_simulator,(void*)&S16_v);
-      r = ((Size16 (ABI_ATTR *) (void)) callback_code) ();
+      BENCH_CLOSURE(r = ((Size16 (ABI_ATTR *) (void)) callback_code) ());
     }
     FREE_CALLBACK();
     fprintf(out,"->{%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c}\n",r.x1,r.x2,r.x3,r.x4,r.x5,r.x6,r.x7,r.x8,r.x9,r.x10,r.x11,r.x12,r.x13,r.x14,r.x15,r.x16);
@@ -2282,7 +2320,7 @@ int main (void)
 #endif    
 
 #if (!defined(DGTEST)) || DGTEST == 52
-    Ir = I_III(I1,I2,I3);
+    BENCH_DIRECT(I_III, Ir = I_III(I1,I2,I3));
     fprintf(out,"->{%d}\n",Ir.x);
     fflush(out);
     Ir.x = 0; clear_traces();
@@ -2298,7 +2336,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_Int);
       PREP_CALLBACK(cif,I_III_simulator,(void*)&I_III);
-      Ir = ((Int (ABI_ATTR *) (Int,Int,Int)) callback_code) (I1,I2,I3);
+      BENCH_CLOSURE(Ir = ((Int (ABI_ATTR *) (Int,Int,Int)) callback_code) (I1,I2,I3));
     }
     FREE_CALLBACK();
     fprintf(out,"->{%d}\n",Ir.x);
@@ -2306,7 +2344,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 53
-    Cr = C_CdC(C1,d2,C3);
+    BENCH_DIRECT(C_CdC, Cr = C_CdC(C1,d2,C3));
     fprintf(out,"->{'%c'}\n",Cr.x);
     fflush(out);
     Cr.x = '\0'; clear_traces();
@@ -2322,7 +2360,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_Char);
       PREP_CALLBACK(cif,C_CdC_simulator,(void*)&C_CdC);
-      Cr = ((Char (ABI_ATTR *) (Char,double,Char)) callback_code) (C1,d2,C3);
+      BENCH_CLOSURE(Cr = ((Char (ABI_ATTR *) (Char,double,Char)) callback_code) (C1,d2,C3));
     }
     FREE_CALLBACK();
     fprintf(out,"->{'%c'}\n",Cr.x);
@@ -2330,7 +2368,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 54    
-    Fr = F_Ffd(F1,f2,d3);
+    BENCH_DIRECT(F_Ffd, Fr = F_Ffd(F1,f2,d3));
     fprintf(out,"->{%g}\n",Fr.x);
     fflush(out);
     Fr.x = 0.0; clear_traces();
@@ -2346,7 +2384,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_Float);
       PREP_CALLBACK(cif,F_Ffd_simulator,(void*)&F_Ffd);
-      Fr = ((Float (ABI_ATTR *) (Float,float,double)) callback_code) (F1,f2,d3);
+      BENCH_CLOSURE(Fr = ((Float (ABI_ATTR *) (Float,float,double)) callback_code) (F1,f2,d3));
     }
     FREE_CALLBACK();
     fprintf(out,"->{%g}\n",Fr.x);
@@ -2354,7 +2392,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 55    
-    Dr = D_fDd(f1,D2,d3);
+    BENCH_DIRECT(D_fDd, Dr = D_fDd(f1,D2,d3));
     fprintf(out,"->{%g}\n",Dr.x);
     fflush(out);
     Dr.x = 0.0; clear_traces();
@@ -2370,7 +2408,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_Double);
       PREP_CALLBACK(cif,D_fDd_simulator,(void*)&D_fDd);
-      Dr = ((Double (ABI_ATTR *) (float,Double,double)) callback_code) (f1,D2,d3);
+      BENCH_CLOSURE(Dr = ((Double (ABI_ATTR *) (float,Double,double)) callback_code) (f1,D2,d3));
     }
     FREE_CALLBACK();
     fprintf(out,"->{%g}\n",Dr.x);
@@ -2378,7 +2416,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 56
-    Dr = D_Dfd(D1,f2,d3);
+    BENCH_DIRECT(D_Dfd, Dr = D_Dfd(D1,f2,d3));
     fprintf(out,"->{%g}\n",Dr.x);
     fflush(out);
     Dr.x = 0.0; clear_traces();
@@ -2394,7 +2432,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_Double);
       PREP_CALLBACK(cif,D_Dfd_simulator,(void*)&D_Dfd);
-      Dr = ((Double (ABI_ATTR *) (Double,float,double)) callback_code) (D1,f2,d3);
+      BENCH_CLOSURE(Dr = ((Double (ABI_ATTR *) (Double,float,double)) callback_code) (D1,f2,d3));
     }
     FREE_CALLBACK();
     fprintf(out,"->{%g}\n",Dr.x);
@@ -2402,7 +2440,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 57
-    Jr = J_JiJ(J1,i2,J2);
+    BENCH_DIRECT(J_JiJ, Jr = J_JiJ(J1,i2,J2));
     fprintf(out,"->{%ld,%ld}\n",Jr.l1,Jr.l2);
     fflush(out);
     Jr.l1 = Jr.l2 = 0; clear_traces();
@@ -2418,7 +2456,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_J);
       PREP_CALLBACK(cif,J_JiJ_simulator,(void*)&J_JiJ);
-      Jr = ((J (ABI_ATTR *) (J,int,J)) callback_code) (J1,i2,J2);
+      BENCH_CLOSURE(Jr = ((J (ABI_ATTR *) (J,int,J)) callback_code) (J1,i2,J2));
     }
     FREE_CALLBACK();
     fprintf(out,"->{%ld,%ld}\n",Jr.l1,Jr.l2);
@@ -2427,7 +2465,7 @@ int main (void)
 
 #ifndef SKIP_EXTRA_STRUCTS
 #if (!defined(DGTEST)) || DGTEST == 58
-    Tr = T_TcT(T1,' ',T2);
+    BENCH_DIRECT(T_TcT, Tr = T_TcT(T1,' ',T2));
     fprintf(out,"->{\"%c%c%c\"}\n",Tr.c[0],Tr.c[1],Tr.c[2]);
     fflush(out);
     Tr.c[0] = Tr.c[1] = Tr.c[2] = 0; clear_traces();
@@ -2443,7 +2481,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_T);
       PREP_CALLBACK(cif,T_TcT_simulator,(void*)&T_TcT);
-      Tr = ((T (ABI_ATTR *) (T,char,T)) callback_code) (T1,' ',T2);
+      BENCH_CLOSURE(Tr = ((T (ABI_ATTR *) (T,char,T)) callback_code) (T1,' ',T2));
     }
     FREE_CALLBACK();
     fprintf(out,"->{\"%c%c%c\"}\n",Tr.c[0],Tr.c[1],Tr.c[2]);
@@ -2452,7 +2490,7 @@ int main (void)
 
 #ifndef SKIP_X
 #if (!defined(DGTEST)) || DGTEST == 59
-    Xr = X_BcdB(B1,c2,d3,B2);
+    BENCH_DIRECT(X_BcdB, Xr = X_BcdB(B1,c2,d3,B2));
     fprintf(out,"->{\"%s\",'%c'}\n",Xr.c,Xr.c1);
     fflush(out);
     Xr.c[0]=Xr.c1='\0'; clear_traces();
@@ -2468,7 +2506,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_X);
       PREP_CALLBACK(cif,X_BcdB_simulator,(void*)&X_BcdB);
-      Xr = ((X (ABI_ATTR *) (B,char,double,B)) callback_code) (B1,c2,d3,B2);
+      BENCH_CLOSURE(Xr = ((X (ABI_ATTR *) (B,char,double,B)) callback_code) (B1,c2,d3,B2));
     }
     FREE_CALLBACK();
     fprintf(out,"->{\"%s\",'%c'}\n",Xr.c,Xr.c1);
@@ -2501,7 +2539,7 @@ int main (void)
     ffi_type_L.elements = ffi_type_L_elements;
 
 #if (!defined(DGTEST)) || DGTEST == 60
-    lr = l_l0K(K1,l9);
+    BENCH_DIRECT(l_l0K, lr = l_l0K(K1,l9));
     fprintf(out,"->%ld\n",lr);
     fflush(out);
     lr = 0; clear_traces();
@@ -2511,7 +2549,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slong);
       PREP_CALLBACK(cif,l_l0K_simulator,(void*)l_l0K);
-      lr = ((long (ABI_ATTR *) (K,long)) callback_code) (K1,l9);
+      BENCH_CLOSURE(lr = ((long (ABI_ATTR *) (K,long)) callback_code) (K1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%ld\n",lr);
@@ -2519,7 +2557,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 61
-    lr = l_l1K(l1,K1,l9);
+    BENCH_DIRECT(l_l1K, lr = l_l1K(l1,K1,l9));
     fprintf(out,"->%ld\n",lr);
     fflush(out);
     lr = 0; clear_traces();
@@ -2529,7 +2567,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slong);
       PREP_CALLBACK(cif,l_l1K_simulator,(void*)l_l1K);
-      lr = ((long (ABI_ATTR *) (long,K,long)) callback_code) (l1,K1,l9);
+      BENCH_CLOSURE(lr = ((long (ABI_ATTR *) (long,K,long)) callback_code) (l1,K1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%ld\n",lr);
@@ -2537,7 +2575,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 62
-    lr = l_l2K(l1,l2,K1,l9);
+    BENCH_DIRECT(l_l2K, lr = l_l2K(l1,l2,K1,l9));
     fprintf(out,"->%ld\n",lr);
     fflush(out);
     lr = 0; clear_traces();
@@ -2547,7 +2585,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slong);
       PREP_CALLBACK(cif,l_l2K_simulator,(void*)l_l2K);
-      lr = ((long (ABI_ATTR *) (long,long,K,long)) callback_code) (l1,l2,K1,l9);
+      BENCH_CLOSURE(lr = ((long (ABI_ATTR *) (long,long,K,long)) callback_code) (l1,l2,K1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%ld\n",lr);
@@ -2555,7 +2593,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 63
-    lr = l_l3K(l1,l2,l3,K1,l9);
+    BENCH_DIRECT(l_l3K, lr = l_l3K(l1,l2,l3,K1,l9));
     fprintf(out,"->%ld\n",lr);
     fflush(out);
     lr = 0; clear_traces();
@@ -2565,7 +2603,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slong);
       PREP_CALLBACK(cif,l_l3K_simulator,(void*)l_l3K);
-      lr = ((long (ABI_ATTR *) (long,long,long,K,long)) callback_code) (l1,l2,l3,K1,l9);
+      BENCH_CLOSURE(lr = ((long (ABI_ATTR *) (long,long,long,K,long)) callback_code) (l1,l2,l3,K1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%ld\n",lr);
@@ -2573,7 +2611,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 64
-    lr = l_l4K(l1,l2,l3,l4,K1,l9);
+    BENCH_DIRECT(l_l4K, lr = l_l4K(l1,l2,l3,l4,K1,l9));
     fprintf(out,"->%ld\n",lr);
     fflush(out);
     lr = 0; clear_traces();
@@ -2583,7 +2621,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slong);
       PREP_CALLBACK(cif,l_l4K_simulator,(void*)l_l4K);
-      lr = ((long (ABI_ATTR *) (long,long,long,long,K,long)) callback_code) (l1,l2,l3,l4,K1,l9);
+      BENCH_CLOSURE(lr = ((long (ABI_ATTR *) (long,long,long,long,K,long)) callback_code) (l1,l2,l3,l4,K1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%ld\n",lr);
@@ -2591,7 +2629,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 65  
-    lr = l_l5K(l1,l2,l3,l4,l5,K1,l9);
+    BENCH_DIRECT(l_l5K, lr = l_l5K(l1,l2,l3,l4,l5,K1,l9));
     fprintf(out,"->%ld\n",lr);
     fflush(out);
     lr = 0; clear_traces();
@@ -2601,7 +2639,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slong);
       PREP_CALLBACK(cif,l_l5K_simulator,(void*)l_l5K);
-      lr = ((long (ABI_ATTR *) (long,long,long,long,long,K,long)) callback_code) (l1,l2,l3,l4,l5,K1,l9);
+      BENCH_CLOSURE(lr = ((long (ABI_ATTR *) (long,long,long,long,long,K,long)) callback_code) (l1,l2,l3,l4,l5,K1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%ld\n",lr);
@@ -2609,7 +2647,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 66
-    lr = l_l6K(l1,l2,l3,l4,l5,l6,K1,l9);
+    BENCH_DIRECT(l_l6K, lr = l_l6K(l1,l2,l3,l4,l5,l6,K1,l9));
     fprintf(out,"->%ld\n",lr);
     fflush(out);
     lr = 0; clear_traces();
@@ -2619,7 +2657,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slong);
       PREP_CALLBACK(cif,l_l6K_simulator,(void*)l_l6K);
-      lr = ((long (ABI_ATTR *) (long,long,long,long,long,long,K,long)) callback_code) (l1,l2,l3,l4,l5,l6,K1,l9);
+      BENCH_CLOSURE(lr = ((long (ABI_ATTR *) (long,long,long,long,long,long,K,long)) callback_code) (l1,l2,l3,l4,l5,l6,K1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%ld\n",lr);
@@ -2627,7 +2665,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 67    
-    fr = f_f17l3L(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,l6,l7,l8,L1);
+    BENCH_DIRECT(f_f17l3L, fr = f_f17l3L(f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,l6,l7,l8,L1));
     fprintf(out,"->%g\n",fr);
     fflush(out);
     fr = 0.0; clear_traces();
@@ -2637,7 +2675,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_float);
       PREP_CALLBACK(cif,f_f17l3L_simulator,(void*)&f_f17l3L);
-      fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,long,long,long,L)) callback_code) (f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,l6,l7,l8,L1);
+      BENCH_CLOSURE(fr = ((float (ABI_ATTR *) (float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,float,long,long,long,L)) callback_code) (f1,f2,f3,f4,f5,f6,f7,f8,f9,f10,f11,f12,f13,f14,f15,f16,f17,l6,l7,l8,L1));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",fr);
@@ -2645,7 +2683,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 68    
-    dr = d_d17l3L(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,d14,d15,d16,d17,l6,l7,l8,L1);
+    BENCH_DIRECT(d_d17l3L, dr = d_d17l3L(d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,d14,d15,d16,d17,l6,l7,l8,L1));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -2655,7 +2693,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_d17l3L_simulator,(void*)&d_d17l3L);
-      dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,double,double,double,double,double,double,double,double,double,double,long,long,long,L)) callback_code) (d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,d14,d15,d16,d17,l6,l7,l8,L1);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (double,double,double,double,double,double,double,double,double,double,double,double,double,double,double,double,double,long,long,long,L)) callback_code) (d1,d2,d3,d4,d5,d6,d7,d8,d9,d10,d11,d12,d13,d14,d15,d16,d17,l6,l7,l8,L1));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -2663,7 +2701,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 69    
-    llr = ll_l2ll(l1,l2,ll1,l9);
+    BENCH_DIRECT(ll_l2ll, llr = ll_l2ll(l1,l2,ll1,l9));
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
     fflush(out);
     llr = 0; clear_traces();
@@ -2673,7 +2711,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slonglong);
       PREP_CALLBACK(cif,ll_l2ll_simulator,(void*)ll_l2ll);
-      llr = ((long long (ABI_ATTR *) (long,long,long long,long)) callback_code) (l1,l2,ll1,l9);
+      BENCH_CLOSURE(llr = ((long long (ABI_ATTR *) (long,long,long long,long)) callback_code) (l1,l2,ll1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
@@ -2681,7 +2719,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 70
-    llr = ll_l3ll(l1,l2,l3,ll1,l9);
+    BENCH_DIRECT(ll_l3ll, llr = ll_l3ll(l1,l2,l3,ll1,l9));
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
     fflush(out);
     llr = 0; clear_traces();
@@ -2691,7 +2729,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slonglong);
       PREP_CALLBACK(cif,ll_l3ll_simulator,(void*)ll_l3ll);
-      llr = ((long long (ABI_ATTR *) (long,long,long,long long,long)) callback_code) (l1,l2,l3,ll1,l9);
+      BENCH_CLOSURE(llr = ((long long (ABI_ATTR *) (long,long,long,long long,long)) callback_code) (l1,l2,l3,ll1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
@@ -2699,7 +2737,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 71    
-    llr = ll_l4ll(l1,l2,l3,l4,ll1,l9);
+    BENCH_DIRECT(ll_l4ll, llr = ll_l4ll(l1,l2,l3,l4,ll1,l9));
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
     fflush(out);
     llr = 0; clear_traces();
@@ -2709,7 +2747,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slonglong);
       PREP_CALLBACK(cif,ll_l4ll_simulator,(void*)ll_l4ll);
-      llr = ((long long (ABI_ATTR *) (long,long,long,long,long long,long)) callback_code) (l1,l2,l3,l4,ll1,l9);
+      BENCH_CLOSURE(llr = ((long long (ABI_ATTR *) (long,long,long,long,long long,long)) callback_code) (l1,l2,l3,l4,ll1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
@@ -2717,7 +2755,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 72    
-    llr = ll_l5ll(l1,l2,l3,l4,l5,ll1,l9);
+    BENCH_DIRECT(ll_l5ll, llr = ll_l5ll(l1,l2,l3,l4,l5,ll1,l9));
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
     fflush(out);
     llr = 0; clear_traces();
@@ -2727,7 +2765,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slonglong);
       PREP_CALLBACK(cif,ll_l5ll_simulator,(void*)ll_l5ll);
-      llr = ((long long (ABI_ATTR *) (long,long,long,long,long,long long,long)) callback_code) (l1,l2,l3,l4,l5,ll1,l9);
+      BENCH_CLOSURE(llr = ((long long (ABI_ATTR *) (long,long,long,long,long,long long,long)) callback_code) (l1,l2,l3,l4,l5,ll1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
@@ -2735,7 +2773,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 73    
-    llr = ll_l6ll(l1,l2,l3,l4,l5,l6,ll1,l9);
+    BENCH_DIRECT(ll_l6ll, llr = ll_l6ll(l1,l2,l3,l4,l5,l6,ll1,l9));
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
     fflush(out);
     llr = 0; clear_traces();
@@ -2745,7 +2783,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slonglong);
       PREP_CALLBACK(cif,ll_l6ll_simulator,(void*)ll_l6ll);
-      llr = ((long long (ABI_ATTR *) (long,long,long,long,long,long,long long,long)) callback_code) (l1,l2,l3,l4,l5,l6,ll1,l9);
+      BENCH_CLOSURE(llr = ((long long (ABI_ATTR *) (long,long,long,long,long,long,long long,long)) callback_code) (l1,l2,l3,l4,l5,l6,ll1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
@@ -2753,7 +2791,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 74    
-    llr = ll_l7ll(l1,l2,l3,l4,l5,l6,l7,ll1,l9);
+    BENCH_DIRECT(ll_l7ll, llr = ll_l7ll(l1,l2,l3,l4,l5,l6,l7,ll1,l9));
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
     fflush(out);
     llr = 0; clear_traces();
@@ -2763,7 +2801,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_slonglong);
       PREP_CALLBACK(cif,ll_l7ll_simulator,(void*)ll_l7ll);
-      llr = ((long long (ABI_ATTR *) (long,long,long,long,long,long,long,long long,long)) callback_code) (l1,l2,l3,l4,l5,l6,l7,ll1,l9);
+      BENCH_CLOSURE(llr = ((long long (ABI_ATTR *) (long,long,long,long,long,long,long,long long,long)) callback_code) (l1,l2,l3,l4,l5,l6,l7,ll1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->0x%lx%08lx\n",(long)(llr>>32),(long)(llr&0xffffffff));
@@ -2771,7 +2809,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 75    
-    dr = d_l2d(l1,l2,ll1,l9);
+    BENCH_DIRECT(d_l2d, dr = d_l2d(l1,l2,ll1,l9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -2781,7 +2819,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_l2d_simulator,(void*)d_l2d);
-      dr = ((double (ABI_ATTR *) (long,long,double,long)) callback_code) (l1,l2,ll1,l9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (long,long,double,long)) callback_code) (l1,l2,ll1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -2789,7 +2827,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 76    
-    dr = d_l3d(l1,l2,l3,ll1,l9);
+    BENCH_DIRECT(d_l3d, dr = d_l3d(l1,l2,l3,ll1,l9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -2799,7 +2837,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_l3d_simulator,(void*)d_l3d);
-      dr = ((double (ABI_ATTR *) (long,long,long,double,long)) callback_code) (l1,l2,l3,ll1,l9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (long,long,long,double,long)) callback_code) (l1,l2,l3,ll1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -2807,7 +2845,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 77    
-    dr = d_l4d(l1,l2,l3,l4,ll1,l9);
+    BENCH_DIRECT(d_l4d, dr = d_l4d(l1,l2,l3,l4,ll1,l9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -2817,7 +2855,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_l4d_simulator,(void*)d_l4d);
-      dr = ((double (ABI_ATTR *) (long,long,long,long,double,long)) callback_code) (l1,l2,l3,l4,ll1,l9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (long,long,long,long,double,long)) callback_code) (l1,l2,l3,l4,ll1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -2825,7 +2863,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 78
-    dr = d_l5d(l1,l2,l3,l4,l5,ll1,l9);
+    BENCH_DIRECT(d_l5d, dr = d_l5d(l1,l2,l3,l4,l5,ll1,l9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -2835,7 +2873,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_l5d_simulator,(void*)d_l5d);
-      dr = ((double (ABI_ATTR *) (long,long,long,long,long,double,long)) callback_code) (l1,l2,l3,l4,l5,ll1,l9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (long,long,long,long,long,double,long)) callback_code) (l1,l2,l3,l4,l5,ll1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -2843,7 +2881,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 79
-    dr = d_l6d(l1,l2,l3,l4,l5,l6,ll1,l9);
+    BENCH_DIRECT(d_l6d, dr = d_l6d(l1,l2,l3,l4,l5,l6,ll1,l9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -2853,7 +2891,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_l6d_simulator,(void*)d_l6d);
-      dr = ((double (ABI_ATTR *) (long,long,long,long,long,long,double,long)) callback_code) (l1,l2,l3,l4,l5,l6,ll1,l9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (long,long,long,long,long,long,double,long)) callback_code) (l1,l2,l3,l4,l5,l6,ll1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
@@ -2861,7 +2899,7 @@ int main (void)
 #endif
 
 #if (!defined(DGTEST)) || DGTEST == 80
-    dr = d_l7d(l1,l2,l3,l4,l5,l6,l7,ll1,l9);
+    BENCH_DIRECT(d_l7d, dr = d_l7d(l1,l2,l3,l4,l5,l6,l7,ll1,l9));
     fprintf(out,"->%g\n",dr);
     fflush(out);
     dr = 0.0; clear_traces();
@@ -2871,7 +2909,7 @@ int main (void)
       ffi_cif cif;
       FFI_PREP_CIF(cif,argtypes,ffi_type_double);
       PREP_CALLBACK(cif,d_l7d_simulator,(void*)d_l7d);
-      dr = ((double (ABI_ATTR *) (long,long,long,long,long,long,long,double,long)) callback_code) (l1,l2,l3,l4,l5,l6,l7,ll1,l9);
+      BENCH_CLOSURE(dr = ((double (ABI_ATTR *) (long,long,long,long,long,long,long,double,long)) callback_code) (l1,l2,l3,l4,l5,l6,l7,ll1,l9));
     }
     FREE_CALLBACK();
     fprintf(out,"->%g\n",dr);
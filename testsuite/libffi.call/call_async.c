@@ -0,0 +1,100 @@
+/* Area:	ffi_call_async
+   Purpose:	Check that asynchronous calls copy their arguments, run,
+		and report completion, with several calls in flight.
+   Limitations:	Targets without threads only check that FFI_BAD_ABI is
+		returned.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run { target { ! *-*-mingw* } } } */
+#include "ffitest.h"
+#include <unistd.h>
+
+#define NCALLS 32
+
+typedef struct
+{
+  int a;
+  double b;
+  char c[13];
+} record;
+
+static long
+combine (int i, record r, double d)
+{
+  return i * 1000 + r.a + (long) r.b + r.c[12] + (long) d;
+}
+
+static int done_pipe[2];
+
+static void
+done (ffi_cif *cif, void *rvalue, void *user_data)
+{
+  int index = (int) (long) user_data;
+
+  (void) cif;
+  (void) rvalue;
+  CHECK(write (done_pipe[1], &index, sizeof (index)) == sizeof (index));
+}
+
+int main (void)
+{
+  ffi_cif cif;
+  ffi_type *args[MAX_ARGS];
+  ffi_type record_type;
+  ffi_type *record_elements[16];
+  void *values[MAX_ARGS];
+  ffi_arg results[NCALLS];
+  char seen[NCALLS];
+  record r;
+  double d;
+  int i, index;
+  ffi_status status;
+
+  record_type.size = record_type.alignment = 0;
+  record_type.type = FFI_TYPE_STRUCT;
+  record_type.elements = record_elements;
+  record_elements[0] = &ffi_type_sint;
+  record_elements[1] = &ffi_type_double;
+  for (i = 0; i < 13; i++)
+    record_elements[2 + i] = &ffi_type_schar;
+  record_elements[15] = NULL;
+
+  args[0] = &ffi_type_sint;
+  args[1] = &record_type;
+  args[2] = &ffi_type_double;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 3, &ffi_type_slong, args) == FFI_OK);
+  CHECK(pipe (done_pipe) == 0);
+
+  values[0] = &i;
+  values[1] = &r;
+  values[2] = &d;
+  memset (&r, 0, sizeof (r));
+  memset (seen, 0, sizeof (seen));
+  for (i = 0; i < NCALLS; i++)
+    {
+      /* The values are overwritten for the next call straight away.  */
+      r.a = i;
+      r.b = 0.5 + i;
+      r.c[12] = (char) i;
+      d = 100.0;
+      status = ffi_call_async (&cif, FFI_FN(combine), &results[i], values,
+			       done, (void *) (long) i);
+      if (status == FFI_BAD_ABI && i == 0)
+	/* No threads on this target.  */
+	exit (0);
+      CHECK(status == FFI_OK);
+    }
+
+  for (i = 0; i < NCALLS; i++)
+    {
+      CHECK(read (done_pipe[0], &index, sizeof (index)) == sizeof (index));
+      CHECK(index >= 0 && index < NCALLS && !seen[index]);
+      seen[index] = 1;
+      CHECK((long) results[index] == index * 1000 + 3 * index + 100);
+    }
+
+  printf ("ok\n");
+  /* { dg-output "ok" } */
+  exit (0);
+}
@@ -0,0 +1,105 @@
+/* Area:	ffi_call_errno
+   Purpose:	Check that errno is swapped in for the callee and captured
+		from it, leaving the caller's errno alone, and that hooks
+		that change errno do not see or disturb the swapped value.
+   Limitations:	none.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+#include <errno.h>
+
+typedef struct
+{
+  long a, b, c;
+} triple;
+
+/* Return the errno seen on entry and leave V in it.  */
+static int
+swap_errno (int v)
+{
+  int old = errno;
+
+  errno = v;
+  return old;
+}
+
+static int
+swap_errno_triple (triple t)
+{
+  int old = errno;
+
+  errno = (int) (t.a + t.b + t.c);
+  return old;
+}
+
+static void
+clobber_errno (ffi_cif *cif, void *data)
+{
+  (void) cif;
+  (void) data;
+  errno = 99;
+}
+
+int main (void)
+{
+  ffi_cif cif;
+  ffi_type *args[MAX_ARGS];
+  ffi_type triple_type;
+  ffi_type *triple_elements[4];
+  void *values[MAX_ARGS];
+  ffi_hooks hooks;
+  ffi_arg res;
+  int v, saved;
+  triple t;
+
+  triple_type.size = triple_type.alignment = 0;
+  triple_type.type = FFI_TYPE_STRUCT;
+  triple_type.elements = triple_elements;
+  triple_elements[0] = triple_elements[1] = triple_elements[2]
+    = &ffi_type_slong;
+  triple_elements[3] = NULL;
+
+  args[0] = &ffi_type_sint;
+  values[0] = &v;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 1, &ffi_type_sint, args) == FFI_OK);
+
+  errno = 7;
+  saved = 33;
+  v = 55;
+  ffi_call_errno (&cif, FFI_FN(swap_errno), &res, values, &saved);
+  CHECK(errno == 7);
+  CHECK((int) res == 33);
+  CHECK(saved == 55);
+
+  /* A signature that takes the generic call path.  */
+  args[0] = &triple_type;
+  values[0] = &t;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 1, &ffi_type_sint, args) == FFI_OK);
+  t.a = 1;
+  t.b = 2;
+  t.c = 3;
+  saved = 44;
+  ffi_call_errno (&cif, FFI_FN(swap_errno_triple), &res, values, &saved);
+  CHECK(errno == 7);
+  CHECK((int) res == 44);
+  CHECK(saved == 6);
+
+  /* Hooks run outside of the swap.  */
+  memset (&hooks, 0, sizeof (hooks));
+  hooks.before_call = clobber_errno;
+  if (ffi_cif_set_hooks (&cif, &hooks) == FFI_OK)
+    {
+      saved = 12;
+      t.c = 10;
+      ffi_call_errno (&cif, FFI_FN(swap_errno_triple), &res, values, &saved);
+      CHECK((int) res == 12);
+      CHECK(saved == 13);
+      CHECK(errno == 99);
+    }
+
+  printf ("ok\n");
+  /* { dg-output "ok" } */
+  exit (0);
+}
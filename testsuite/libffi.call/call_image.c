@@ -0,0 +1,126 @@
+/* Area:	ffi_get_image_layout, ffi_call_image
+   Purpose:	Check that a call image filled in by hand from the
+		reported layout passes register and stack arguments,
+		and that struct return values are handled.
+   Limitations:	Targets without call images only check that
+		FFI_BAD_ABI is returned.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+
+typedef struct
+{
+  long a, b, c;
+} triple;
+
+static double ABI_ATTR
+mixed (int i, double d, long l1, long l2, long l3, long l4, long l5,
+       float f, long stack)
+{
+  return i + d + l1 + l2 + l3 + l4 + l5 + f + stack;
+}
+
+static triple ABI_ATTR
+make_triple (long a, triple t)
+{
+  triple r;
+
+  r.a = a + t.a;
+  r.b = a + t.b;
+  r.c = a + t.c;
+  return r;
+}
+
+/* Store VALUE, SIZE bytes long, as argument I of IMAGE, widening
+   integers that go in a register slot.  */
+static void
+put (char *image, const ffi_image_layout *layout, const size_t *offsets,
+     unsigned i, const void *value, size_t size)
+{
+  CHECK(offsets[i] != FFI_IMAGE_SPLIT);
+  CHECK(offsets[i] + size <= layout->size);
+  memcpy (image + offsets[i], value, size);
+}
+
+int main (void)
+{
+  ffi_cif cif;
+  ffi_type *args[MAX_ARGS];
+  ffi_image_layout layout;
+  size_t offsets[MAX_ARGS];
+  ffi_type triple_type;
+  ffi_type *triple_elements[4];
+  ffi_status status;
+  char *image;
+  double d = 0.5, dres;
+  float f = 0.25f;
+  long i = -3, l = 10, stack = 1000;
+  triple t = { 1, 2, 3 }, tres;
+  unsigned n;
+
+  args[0] = &ffi_type_sint;
+  args[1] = &ffi_type_double;
+  for (n = 2; n < 7; n++)
+    args[n] = &ffi_type_slong;
+  args[7] = &ffi_type_float;
+  args[8] = &ffi_type_slong;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 9, &ffi_type_double, args) == FFI_OK);
+
+  status = ffi_get_image_layout (&cif, &layout, offsets);
+  if (status == FFI_BAD_ABI)
+    {
+      /* Not supported by this target.  */
+      exit (0);
+    }
+  CHECK(status == FFI_OK);
+  CHECK(layout.gpr_size >= sizeof (long));
+
+  image = calloc (1, layout.size);
+  CHECK(image != NULL);
+  /* The int is widened to fill its slot.  */
+  put (image, &layout, offsets, 0, &i, sizeof (long));
+  put (image, &layout, offsets, 1, &d, sizeof (double));
+  for (n = 2; n < 7; n++)
+    put (image, &layout, offsets, n, &l, sizeof (long));
+  put (image, &layout, offsets, 7, &f, sizeof (float));
+  put (image, &layout, offsets, 8, &stack, sizeof (long));
+
+  ffi_call_image (&cif, FFI_FN(mixed), &dres, image);
+  printf ("%f\n", dres);
+  CHECK(dres == mixed (i, d, l, l, l, l, l, f, stack));
+
+  /* The image is not modified, so it can be reused.  */
+  ffi_call_image (&cif, FFI_FN(mixed), &dres, image);
+  CHECK(dres == mixed (i, d, l, l, l, l, l, f, stack));
+  free (image);
+
+  /* A struct returned in memory.  */
+  triple_type.size = triple_type.alignment = 0;
+  triple_type.type = FFI_TYPE_STRUCT;
+  triple_type.elements = triple_elements;
+  triple_elements[0] = triple_elements[1] = triple_elements[2]
+    = &ffi_type_slong;
+  triple_elements[3] = NULL;
+
+  args[0] = &ffi_type_slong;
+  args[1] = &triple_type;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 2, &triple_type, args) == FFI_OK);
+  CHECK(ffi_get_image_layout (&cif, &layout, offsets) == FFI_OK);
+
+  image = calloc (1, layout.size);
+  CHECK(image != NULL);
+  put (image, &layout, offsets, 0, &l, sizeof (long));
+  put (image, &layout, offsets, 1, &t, sizeof (t));
+
+  memset (&tres, 0, sizeof (tres));
+  ffi_call_image (&cif, FFI_FN(make_triple), &tres, image);
+  CHECK(tres.a == 11 && tres.b == 12 && tres.c == 13);
+
+  /* A NULL rvalue discards the result.  */
+  ffi_call_image (&cif, FFI_FN(make_triple), NULL, image);
+  free (image);
+
+  exit(0);
+}
@@ -0,0 +1,123 @@
+/* Area:	ffi_call_on_stack
+   Purpose:	Check that calls on a supplied stack run there, with
+		register, stack and struct arguments and return values,
+		and come back to the original stack, and that a stack
+		too small for the arguments is refused.
+   Limitations:	Targets that cannot switch stacks only check that
+		FFI_BAD_ABI is returned.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+
+#define STACK_SIZE (256 * 1024)
+
+typedef struct
+{
+  long a, b, c;
+} triple;
+
+static char *stack;
+
+static int
+on_stack (void *p)
+{
+  return (char *) p >= stack && (char *) p < stack + STACK_SIZE;
+}
+
+/* Use more stack than the argument area.  */
+static long
+depth (int n)
+{
+  volatile char buf[256];
+
+  buf[0] = (char) n;
+  return n == 0 ? buf[0] : depth (n - 1) + 1;
+}
+
+static triple
+many (long l0, double d0, long l1, double d1, long l2, double d2,
+      long l3, double d3, long l4, double d4, long l5, double d5,
+      long l6, double d6, long l7, double d7, long l8, double d8,
+      triple t)
+{
+  triple r;
+  int local;
+
+  CHECK(on_stack (&local));
+  r.a = l0 + l1 + l2 + l3 + l4 + l5 + l6 + l7 + l8;
+  r.b = (long) (d0 + d1 + d2 + d3 + d4 + d5 + d6 + d7 + d8);
+  r.c = t.a + t.b + t.c + depth (200);
+  return r;
+}
+
+int main (void)
+{
+  ffi_cif cif;
+  ffi_type *args[MAX_ARGS];
+  ffi_type triple_type;
+  ffi_type *triple_elements[4];
+  void *values[MAX_ARGS];
+  long l[9];
+  double d[9];
+  triple t, r;
+  ffi_arg res;
+  ffi_status status;
+  int i, local;
+
+  stack = malloc (STACK_SIZE);
+  CHECK(stack != NULL);
+
+  triple_type.size = triple_type.alignment = 0;
+  triple_type.type = FFI_TYPE_STRUCT;
+  triple_type.elements = triple_elements;
+  triple_elements[0] = triple_elements[1] = triple_elements[2]
+    = &ffi_type_slong;
+  triple_elements[3] = NULL;
+
+  for (i = 0; i < 9; i++)
+    {
+      l[i] = i + 1;
+      d[i] = 0.5 * (i + 1);
+      args[2 * i] = &ffi_type_slong;
+      args[2 * i + 1] = &ffi_type_double;
+      values[2 * i] = &l[i];
+      values[2 * i + 1] = &d[i];
+    }
+  t.a = 100;
+  t.b = 200;
+  t.c = 300;
+  args[18] = &triple_type;
+  values[18] = &t;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 19, &triple_type, args) == FFI_OK);
+
+  status = ffi_call_on_stack (&cif, FFI_FN(many), &r, values,
+			      stack, STACK_SIZE);
+  if (status == FFI_BAD_ABI)
+    /* Not supported by this target.  */
+    exit (0);
+  CHECK(status == FFI_OK);
+  CHECK(r.a == 45 && r.b == 22 && r.c == 600 + 200);
+  CHECK(!on_stack (&local));
+
+  /* A stack without room for the arguments is refused.  */
+  r.a = r.b = r.c = 0;
+  CHECK(ffi_call_on_stack (&cif, FFI_FN(many), &r, values,
+			   stack, 64) == FFI_BAD_ARGTYPE);
+  CHECK(r.a == 0 && r.b == 0 && r.c == 0);
+
+  /* A call whose return value comes back in a register.  */
+  args[0] = &ffi_type_sint;
+  values[0] = &i;
+  i = 100;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 1, &ffi_type_slong, args) == FFI_OK);
+  CHECK(ffi_call_on_stack (&cif, FFI_FN(depth), &res, values,
+			   stack, STACK_SIZE) == FFI_OK);
+  CHECK((long) res == 100);
+
+  free (stack);
+  printf ("ok\n");
+  /* { dg-output "ok" } */
+  exit (0);
+}
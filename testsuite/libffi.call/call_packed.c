@@ -0,0 +1,127 @@
+/* Area:	ffi_get_packed_offsets, ffi_call_packed
+   Purpose:	Check that arguments are laid out in a packed block like
+		the members of the equivalent structure, and that calls
+		read them from there, whether or not every argument fits
+		in a register.
+   Limitations:	none.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+#include <stddef.h>
+
+typedef struct
+{
+  char c;
+  short s;
+} small;
+
+/* The packed block of mixed's arguments.  */
+struct mixed_args
+{
+  signed char c;
+  double d;
+  short s;
+  small sm;
+  int i;
+  long long ll;
+  float f;
+};
+
+/* Arguments that all go in registers.  */
+struct scalar_args
+{
+  signed char c;
+  float f;
+  short s;
+  double d;
+  void *p;
+};
+
+static double ABI_ATTR
+scalars (signed char c, float f, short s, double d, void *p)
+{
+  return c + f + s + d + (p == NULL);
+}
+
+static double ABI_ATTR
+mixed (signed char c, double d, short s, small sm, int i, long long ll,
+       float f)
+{
+  return c + d + s + sm.c + sm.s + i + ll + f;
+}
+
+int main (void)
+{
+  ffi_cif cif;
+  ffi_type *args[MAX_ARGS];
+  ffi_type small_type;
+  ffi_type *small_elements[3];
+  size_t offsets[MAX_ARGS], size;
+  struct mixed_args block;
+  struct scalar_args sblock;
+  double res;
+
+  small_type.size = small_type.alignment = 0;
+  small_type.type = FFI_TYPE_STRUCT;
+  small_type.elements = small_elements;
+  small_elements[0] = &ffi_type_schar;
+  small_elements[1] = &ffi_type_sshort;
+  small_elements[2] = NULL;
+
+  args[0] = &ffi_type_schar;
+  args[1] = &ffi_type_double;
+  args[2] = &ffi_type_sshort;
+  args[3] = &small_type;
+  args[4] = &ffi_type_sint;
+  args[5] = &ffi_type_sint64;
+  args[6] = &ffi_type_float;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 7, &ffi_type_double, args) == FFI_OK);
+
+  CHECK(ffi_get_packed_offsets (&cif, offsets, &size) == FFI_OK);
+  CHECK(offsets[0] == offsetof (struct mixed_args, c));
+  CHECK(offsets[1] == offsetof (struct mixed_args, d));
+  CHECK(offsets[2] == offsetof (struct mixed_args, s));
+  CHECK(offsets[3] == offsetof (struct mixed_args, sm));
+  CHECK(offsets[4] == offsetof (struct mixed_args, i));
+  CHECK(offsets[5] == offsetof (struct mixed_args, ll));
+  CHECK(offsets[6] == offsetof (struct mixed_args, f));
+  CHECK(size == sizeof (struct mixed_args));
+
+  block.c = -5;
+  block.d = 0.5;
+  block.s = -300;
+  block.sm.c = 7;
+  block.sm.s = 1000;
+  block.i = 123456;
+  block.ll = 1LL << 40;
+  block.f = 0.25f;
+
+  ffi_call_packed (&cif, FFI_FN(mixed), &res, &block);
+  printf ("%f\n", res);
+  CHECK(res == mixed (block.c, block.d, block.s, block.sm, block.i,
+		      block.ll, block.f));
+
+  args[0] = &ffi_type_schar;
+  args[1] = &ffi_type_float;
+  args[2] = &ffi_type_sshort;
+  args[3] = &ffi_type_double;
+  args[4] = &ffi_type_pointer;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 5, &ffi_type_double, args) == FFI_OK);
+  sblock.c = -9;
+  sblock.f = 1.5f;
+  sblock.s = -2000;
+  sblock.d = 0.125;
+  sblock.p = NULL;
+  res = 0;
+  ffi_call_packed (&cif, FFI_FN(scalars), &res, &sblock);
+  CHECK(res == scalars (sblock.c, sblock.f, sblock.s, sblock.d, sblock.p));
+
+  /* No arguments: an empty block.  */
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 0, &ffi_type_void, NULL) == FFI_OK);
+  CHECK(ffi_get_packed_offsets (&cif, NULL, &size) == FFI_OK);
+  CHECK(size == 0);
+
+  exit(0);
+}
@@ -0,0 +1,114 @@
+/* Area:	ffi_record_start, ffi_record_stop
+   Purpose:	Check that calls and closure invocations are written to
+		the trace while recording, each signature being defined
+		once, and not otherwise.
+   Limitations:	Targets that cannot record only check that FFI_BAD_ABI
+		is returned.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+#include <unistd.h>
+
+static int
+add (int a, int b)
+{
+  return a + b;
+}
+
+static void
+handler (ffi_cif *cif, void *resp, void **args, void *userdata)
+{
+  (void) cif;
+  (void) userdata;
+  *(ffi_arg *) resp = *(int *) args[0] + *(int *) args[1];
+}
+
+static double
+half (double d)
+{
+  return d / 2;
+}
+
+int main (void)
+{
+  ffi_cif cif_add, cif_half;
+  ffi_type *add_args[2], *half_args[1];
+  void *values[2];
+  ffi_closure *cl;
+  void *code;
+  ffi_status status;
+  ffi_arg res;
+  int a = 2, b = 3, i, c, defs = 0, calls = 0, closures = 0;
+  double d = 3.0, r;
+  char path[64], magic[sizeof (FFI_RECORD_MAGIC)];
+  FILE *f;
+
+  add_args[0] = add_args[1] = &ffi_type_sint;
+  CHECK(ffi_prep_cif(&cif_add, ABI_NUM, 2, &ffi_type_sint, add_args)
+	== FFI_OK);
+  half_args[0] = &ffi_type_double;
+  CHECK(ffi_prep_cif(&cif_half, ABI_NUM, 1, &ffi_type_double, half_args)
+	== FFI_OK);
+  cl = ffi_closure_alloc (sizeof (ffi_closure), &code);
+  CHECK(cl != NULL);
+  CHECK(ffi_prep_closure_loc (cl, &cif_add, handler, NULL, code) == FFI_OK);
+
+  snprintf (path, sizeof (path), "call_record.%d.trace", (int) getpid ());
+  status = ffi_record_start (path);
+  if (status == FFI_BAD_ABI)
+    /* Not supported by this target.  */
+    exit (0);
+  CHECK(status == FFI_OK);
+
+  values[0] = &a;
+  values[1] = &b;
+  for (i = 0; i < 5; i++)
+    ffi_call (&cif_add, FFI_FN(add), &res, values);
+  CHECK((int) res == 5);
+  values[0] = &d;
+  ffi_call (&cif_half, FFI_FN(half), &r, values);
+  CHECK(r == 1.5);
+  CHECK(((int (*)(int, int)) code) (1, 2) == 3);
+  ffi_record_stop ();
+
+  /* Not recorded.  */
+  ffi_call (&cif_half, FFI_FN(half), &r, values);
+
+  f = fopen (path, "rb");
+  CHECK(f != NULL);
+  CHECK(fread (magic, sizeof (magic), 1, f) == 1);
+  CHECK(memcmp (magic, FFI_RECORD_MAGIC, sizeof (magic)) == 0);
+  /* Definitions are followed by types, so count only the events after
+     the last one, which are 5 bytes each.  */
+  while ((c = getc (f)) != EOF)
+    {
+      if (c == 'S')
+	{
+	  defs++;
+	  calls = closures = 0;
+	  /* id, abi, nargs, then one byte per scalar type.  */
+	  CHECK(fseek (f, 4 + 1 + 2, SEEK_CUR) == 0);
+	  continue;
+	}
+      if (c == 'C')
+	calls++;
+      else if (c == 'K')
+	closures++;
+      else
+	continue;
+      CHECK(fseek (f, 4, SEEK_CUR) == 0);
+    }
+  fclose (f);
+  remove (path);
+  CHECK(defs == 2);
+  /* The closure is the last event, after the definition of cif_half
+     and its call.  */
+  CHECK(calls == 1 && closures == 1);
+
+  ffi_closure_free (cl);
+  printf ("ok\n");
+  /* { dg-output "ok" } */
+  exit (0);
+}
@@ -0,0 +1,193 @@
+/* Area:	ffi_call, ffi_set_tier_threshold, ffi_cif_release
+   Purpose:	Check that calls keep their results when ffi_call starts
+		going through a plan for a hot cif, that preparing
+		the cif again drops the plan, that hooks set on a
+		promoted cif still run, and that a promoted cif
+		copied over one that was not released does not pick
+		up its plan.
+   Limitations:	none.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+
+struct big
+{
+  long a, b, c;
+  double d;
+};
+
+static struct big
+scale (struct big s, int k, double f)
+{
+  struct big r;
+
+  r.a = s.a * k;
+  r.b = s.b * k;
+  r.c = s.c * k;
+  r.d = s.d * f;
+  return r;
+}
+
+static long
+sum (struct big s, long k)
+{
+  return s.a + s.b + s.c + (long) s.d + k;
+}
+
+static int hook_calls;
+
+static void
+count_hook (ffi_cif *cif, void *data)
+{
+  (void) cif;
+  (void) data;
+  hook_calls++;
+}
+
+static long
+sub3 (long a, long b, long c)
+{
+  return a - b - c;
+}
+
+int main (void)
+{
+  ffi_cif cif, other;
+  ffi_type big_type, *big_elements[5], *args[3], *big_args[3];
+  ffi_hooks hooks;
+  void *values[3];
+  struct big s, r;
+  long a, b, c, lr;
+  int k, i;
+  double f;
+
+  big_type.size = 0;
+  big_type.alignment = 0;
+  big_type.type = FFI_TYPE_STRUCT;
+  big_type.elements = big_elements;
+  big_elements[0] = &ffi_type_slong;
+  big_elements[1] = &ffi_type_slong;
+  big_elements[2] = &ffi_type_slong;
+  big_elements[3] = &ffi_type_double;
+  big_elements[4] = NULL;
+
+  ffi_set_tier_threshold (10);
+
+  args[0] = &big_type;
+  args[1] = &ffi_type_sint;
+  args[2] = &ffi_type_double;
+  CHECK (ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 3, &big_type, args) == FFI_OK);
+
+  values[0] = &s;
+  values[1] = &k;
+  values[2] = &f;
+  for (i = 0; i < 100; i++)
+    {
+      s.a = i;
+      s.b = -i;
+      s.c = 2 * i;
+      s.d = i + 0.5;
+      k = i % 7;
+      f = 2.0;
+      memset (&r, 0, sizeof (r));
+      ffi_call (&cif, FFI_FN (scale), &r, values);
+      CHECK (r.a == i * (i % 7));
+      CHECK (r.b == -i * (i % 7));
+      CHECK (r.c == 2 * i * (i % 7));
+      CHECK (r.d == 2 * i + 1.0);
+    }
+
+  /* A promoted cif still allows the return value to be ignored.  */
+  ffi_call (&cif, FFI_FN (scale), NULL, values);
+
+  /* Hooks are run for a promoted cif, which keeps its plan.  */
+  memset (&hooks, 0, sizeof (hooks));
+  hooks.before_call = count_hook;
+  hooks.after_call = count_hook;
+  CHECK (ffi_cif_set_hooks (&cif, &hooks) == FFI_OK);
+  memset (&r, 0, sizeof (r));
+  ffi_call (&cif, FFI_FN (scale), &r, values);
+  CHECK (hook_calls == 2);
+  CHECK (r.a == 99 * (99 % 7) && r.d == 199.0);
+  CHECK (ffi_cif_set_hooks (&cif, NULL) == FFI_OK);
+  ffi_call (&cif, FFI_FN (scale), &r, values);
+  CHECK (hook_calls == 2);
+
+  /* The same cif prepared for another signature.  */
+  args[0] = &ffi_type_slong;
+  args[1] = &ffi_type_slong;
+  args[2] = &ffi_type_slong;
+  CHECK (ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 3, &ffi_type_slong, args)
+	 == FFI_OK);
+  values[0] = &a;
+  values[1] = &b;
+  values[2] = &c;
+  for (i = 0; i < 100; i++)
+    {
+      a = 100 * i;
+      b = i;
+      c = 3;
+      ffi_call (&cif, FFI_FN (sub3), &lr, values);
+      CHECK (lr == 99 * i - 3);
+    }
+
+  /* CIF is promoted for SUM, but is overwritten without being released
+     by a promoted cif for SCALE.  */
+  big_args[0] = &big_type;
+  big_args[1] = &ffi_type_slong;
+  CHECK (ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 2, &ffi_type_slong, big_args)
+	 == FFI_OK);
+  values[0] = &s;
+  values[1] = &a;
+  s.a = 1;
+  s.b = 2;
+  s.c = 3;
+  s.d = 4.0;
+  a = 5;
+  for (i = 0; i < 100; i++)
+    {
+      ffi_call (&cif, FFI_FN (sum), &lr, values);
+      CHECK (lr == 15);
+    }
+
+  big_args[0] = &big_type;
+  big_args[1] = &ffi_type_sint;
+  big_args[2] = &ffi_type_double;
+  CHECK (ffi_prep_cif (&other, FFI_DEFAULT_ABI, 3, &big_type, big_args)
+	 == FFI_OK);
+  values[1] = &k;
+  values[2] = &f;
+  k = 5;
+  f = 0.5;
+  for (i = 0; i < 100; i++)
+    ffi_call (&other, FFI_FN (scale), &r, values);
+  memcpy (&cif, &other, sizeof (cif));
+  memset (&r, 0, sizeof (r));
+  ffi_call (&cif, FFI_FN (scale), &r, values);
+  CHECK (r.a == 5 && r.b == 10 && r.c == 15 && r.d == 2.0);
+  ffi_cif_release (&cif);
+  ffi_cif_release (&other);
+  memset (&r, 0, sizeof (r));
+  ffi_call (&other, FFI_FN (scale), &r, values);
+  CHECK (r.a == 5 && r.b == 10 && r.c == 15 && r.d == 2.0);
+  values[0] = &a;
+  values[1] = &b;
+  values[2] = &c;
+
+  /* Nothing is promoted any more.  */
+  ffi_set_tier_threshold (0);
+  CHECK (ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 3, &ffi_type_slong, args)
+	 == FFI_OK);
+  for (i = 0; i < 100; i++)
+    {
+      a = i;
+      b = 2 * i;
+      c = -i;
+      ffi_call (&cif, FFI_FN (sub3), &lr, values);
+      CHECK (lr == 0);
+    }
+
+  exit (0);
+}
@@ -0,0 +1,127 @@
+/* Area:	ffi_call, ffi_set_tier_threshold, ffi_cif_release
+   Purpose:	Check that a cif called from several threads at once is
+		promoted without losing results, and that once the
+		threads are done with it, it can be released or prepared
+		again for another signature and shared again.
+   Limitations:	none.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run { target { ! *-*-mingw* } } } */
+#include "ffitest.h"
+#include <pthread.h>
+
+#define NTHREADS 4
+#define NCALLS 2000
+
+struct big
+{
+  long a, b, c;
+  double d;
+};
+
+static ffi_cif cif;
+static int use_big;
+
+static long
+sum8 (long a, long b, long c, long d, long e, long f, long g, long h)
+{
+  return a + b + c + d + e + f + g + h;
+}
+
+static long
+sum_big (struct big s, long k)
+{
+  return s.a + s.b + s.c + (long) s.d + k;
+}
+
+static void *
+worker (void *arg)
+{
+  long base = (long) arg * NCALLS, x[8], k, r;
+  struct big s;
+  void *values[8];
+  int i, j;
+
+  for (i = 0; i < NCALLS; i++)
+    {
+      if (use_big)
+	{
+	  s.a = base + i;
+	  s.b = 1;
+	  s.c = 2;
+	  s.d = 3.0;
+	  k = -i;
+	  values[0] = &s;
+	  values[1] = &k;
+	  ffi_call (&cif, FFI_FN (sum_big), &r, values);
+	  CHECK (r == base + 6);
+	}
+      else
+	{
+	  for (j = 0; j < 8; j++)
+	    {
+	      x[j] = base + i + j;
+	      values[j] = &x[j];
+	    }
+	  ffi_call (&cif, FFI_FN (sum8), &r, values);
+	  CHECK (r == 8 * (base + i) + 28);
+	}
+    }
+  return NULL;
+}
+
+static void
+run_threads (void)
+{
+  pthread_t threads[NTHREADS];
+  long i;
+
+  for (i = 0; i < NTHREADS; i++)
+    CHECK (pthread_create (&threads[i], NULL, worker, (void *) i) == 0);
+  for (i = 0; i < NTHREADS; i++)
+    CHECK (pthread_join (threads[i], NULL) == 0);
+}
+
+int main (void)
+{
+  ffi_type big_type, *big_elements[5], *args[8], *big_args[2];
+  int i;
+
+  big_type.size = 0;
+  big_type.alignment = 0;
+  big_type.type = FFI_TYPE_STRUCT;
+  big_type.elements = big_elements;
+  big_elements[0] = &ffi_type_slong;
+  big_elements[1] = &ffi_type_slong;
+  big_elements[2] = &ffi_type_slong;
+  big_elements[3] = &ffi_type_double;
+  big_elements[4] = NULL;
+  big_args[0] = &big_type;
+  big_args[1] = &ffi_type_slong;
+  for (i = 0; i < 8; i++)
+    args[i] = &ffi_type_slong;
+
+  ffi_set_tier_threshold (50);
+
+  CHECK (ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 8, &ffi_type_slong, args)
+	 == FFI_OK);
+  run_threads ();
+
+  /* The plan and hooks of a cif are only dropped while no thread is
+     calling it.  */
+  ffi_cif_release (&cif);
+  use_big = 1;
+  CHECK (ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 2, &ffi_type_slong, big_args)
+	 == FFI_OK);
+  run_threads ();
+
+  use_big = 0;
+  CHECK (ffi_prep_cif (&cif, FFI_DEFAULT_ABI, 8, &ffi_type_slong, args)
+	 == FFI_OK);
+  run_threads ();
+  ffi_cif_release (&cif);
+
+  ffi_set_tier_threshold (0);
+  exit (0);
+}
@@ -0,0 +1,173 @@
+/* Area:	ffi_cif_cache_write, ffi_cif_cache_open
+   Purpose:	Check that cifs written to a cache and mapped again call
+		and bind closures like the cifs they were written from,
+		and that a damaged cache, or one that holds a raw
+		pointer, is refused.
+   Limitations:	none.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+#include <stdarg.h>
+#include <unistd.h>
+
+struct pt
+{
+  int x;
+  double y;
+  char tag;
+};
+
+static struct pt
+move (struct pt p, int dx, double dy)
+{
+  p.x += dx;
+  p.y += dy;
+  p.tag++;
+  return p;
+}
+
+static int
+sum (int n, ...)
+{
+  va_list ap;
+  int s = 0;
+
+  va_start (ap, n);
+  while (n-- > 0)
+    s += va_arg (ap, int);
+  va_end (ap);
+  return s;
+}
+
+static void
+handler (ffi_cif *cif, void *resp, void **args, void *userdata)
+{
+  (void) cif;
+  (void) userdata;
+  *(struct pt *) resp = move (*(struct pt *) args[0], *(int *) args[1],
+			      *(double *) args[2]);
+}
+
+int main (void)
+{
+  ffi_cif move_cif, sum_cif, *cifs[2], *cif;
+  ffi_type pt_type, *pt_elements[4], *move_args[3], *sum_args[4];
+  ffi_cif_cache *cache;
+  char path[] = "/tmp/cif_cacheXXXXXX";
+  void *values[4], *code;
+  struct pt p, r;
+  int dx, n, a, b, c, sr;
+  ffi_arg ar;
+  double dy;
+  ffi_closure *cl;
+  ffi_cif copy;
+  ffi_type *raw;
+  FILE *f;
+  long off;
+  int fd;
+
+  pt_type.size = 0;
+  pt_type.alignment = 0;
+  pt_type.type = FFI_TYPE_STRUCT;
+  pt_type.elements = pt_elements;
+  pt_elements[0] = &ffi_type_sint;
+  pt_elements[1] = &ffi_type_double;
+  pt_elements[2] = &ffi_type_schar;
+  pt_elements[3] = NULL;
+
+  move_args[0] = &pt_type;
+  move_args[1] = &ffi_type_sint;
+  move_args[2] = &ffi_type_double;
+  CHECK (ffi_prep_cif (&move_cif, FFI_DEFAULT_ABI, 3, &pt_type, move_args)
+	 == FFI_OK);
+  sum_args[0] = sum_args[1] = sum_args[2] = sum_args[3] = &ffi_type_sint;
+  CHECK (ffi_prep_cif_var (&sum_cif, FFI_DEFAULT_ABI, 1, 4, &ffi_type_sint,
+			   sum_args) == FFI_OK);
+
+  fd = mkstemp (path);
+  CHECK (fd >= 0);
+  close (fd);
+  cifs[0] = &move_cif;
+  cifs[1] = &sum_cif;
+  CHECK (ffi_cif_cache_write (path, cifs, 2) == FFI_OK);
+
+  cache = ffi_cif_cache_open (path);
+  CHECK (cache != NULL);
+  CHECK (ffi_cif_cache_count (cache) == 2);
+
+  cif = ffi_cif_cache_cif (cache, 0);
+  CHECK (cif->nargs == 3);
+  CHECK (cif->bytes == move_cif.bytes && cif->flags == move_cif.flags);
+  CHECK (cif->rtype == cif->arg_types[0] && cif->rtype != &pt_type);
+  CHECK (cif->rtype->size == pt_type.size);
+  CHECK (cif->arg_types[1] == &ffi_type_sint);
+
+  p.x = 1;
+  p.y = 2.5;
+  p.tag = 'a';
+  dx = 10;
+  dy = 0.25;
+  values[0] = &p;
+  values[1] = &dx;
+  values[2] = &dy;
+  ffi_call (cif, FFI_FN (move), &r, values);
+  CHECK (r.x == 11 && r.y == 2.75 && r.tag == 'b');
+
+  cl = ffi_closure_alloc (sizeof (ffi_closure), &code);
+  CHECK (cl != NULL);
+  CHECK (ffi_prep_closure_loc (cl, cif, handler, NULL, code) == FFI_OK);
+  memset (&r, 0, sizeof (r));
+  r = ((struct pt (*) (struct pt, int, double)) code) (p, 1, 1.0);
+  CHECK (r.x == 2 && r.y == 3.5 && r.tag == 'b');
+  ffi_closure_free (cl);
+
+  cif = ffi_cif_cache_cif (cache, 1);
+  n = 3;
+  a = 4;
+  b = 5;
+  c = 6;
+  values[0] = &n;
+  values[1] = &a;
+  values[2] = &b;
+  values[3] = &c;
+  ffi_call (cif, FFI_FN (sum), &ar, values);
+  sr = (int) ar;
+  CHECK (sr == 15);
+
+  ffi_cif_cache_close (cache);
+
+  /* A pointer stored as it is in the file is not trusted, even if it
+     points to a real type.  */
+  f = fopen (path, "r+b");
+  CHECK (f != NULL);
+  for (off = 0; fseek (f, off, SEEK_SET) == 0
+	 && fread (&copy, sizeof (copy), 1, f) == 1; off += 8)
+    if (copy.abi == move_cif.abi && copy.nargs == 3
+	&& copy.bytes == move_cif.bytes && copy.flags == move_cif.flags)
+      break;
+  CHECK (copy.nargs == 3);
+  raw = &ffi_type_sint;
+  fseek (f, off + offsetof (ffi_cif, rtype), SEEK_SET);
+  fwrite (&raw, sizeof (raw), 1, f);
+  fclose (f);
+  cache = ffi_cif_cache_open (path);
+  CHECK (cache != NULL);
+  CHECK (ffi_cif_cache_cif (cache, 0) == NULL);
+  CHECK (ffi_cif_cache_cif (cache, 1) != NULL);
+  ffi_cif_cache_close (cache);
+
+  /* A cache from another build is refused.  */
+  f = fopen (path, "r+b");
+  CHECK (f != NULL);
+  fseek (f, 8, SEEK_SET);
+  fputc ('?', f);
+  fclose (f);
+  CHECK (ffi_cif_cache_open (path) == NULL);
+
+  unlink (path);
+  CHECK (ffi_cif_cache_open (path) == NULL);
+
+  exit (0);
+}
@@ -0,0 +1,134 @@
+/* Area:	ffi_plan_alloc, ffi_call_plan
+   Purpose:	Check that calls through a plan match ffi_call, for
+		register, stack and in-memory arguments and returns.
+   Limitations:	none.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+
+typedef struct
+{
+  double d;
+  long l;
+} mixed_pair;
+
+typedef struct
+{
+  long a, b, c, d;
+} big_struct;
+
+static long ABI_ATTR
+many_mixed (signed char c, short s, int i, long l, float f, double d,
+	    mixed_pair p, big_struct b, long l7, long l8, double d9)
+{
+  return c + s + i + l + (long) f + (long) d + (long) p.d + p.l
+    + b.a + b.b + b.c + b.d + l7 + l8 + (long) d9;
+}
+
+static big_struct ABI_ATTR
+make_big (long a, double b)
+{
+  big_struct r;
+
+  r.a = a;
+  r.b = (long) b;
+  r.c = a * 2;
+  r.d = -a;
+  return r;
+}
+
+static int zero_calls;
+
+static void ABI_ATTR
+zero (void)
+{
+  zero_calls++;
+}
+
+int main (void)
+{
+  ffi_cif cif;
+  ffi_plan *plan;
+  ffi_type *args[MAX_ARGS];
+  void *values[MAX_ARGS];
+  ffi_type pair_type, big_type;
+  ffi_type *pair_elements[3], *big_elements[5];
+  signed char c = -3;
+  short s = -300;
+  int i = 70000;
+  long l = -123456, l7 = 7, l8 = -8;
+  float f = 2.5f;
+  double d = -12.75, d9 = 9.0;
+  mixed_pair p = { 1.5, -11 };
+  big_struct b = { 1, -2, 3, -4 }, r;
+  ffi_arg res, expected;
+
+  pair_type.size = pair_type.alignment = 0;
+  pair_type.type = FFI_TYPE_STRUCT;
+  pair_type.elements = pair_elements;
+  pair_elements[0] = &ffi_type_double;
+  pair_elements[1] = &ffi_type_slong;
+  pair_elements[2] = NULL;
+
+  big_type.size = big_type.alignment = 0;
+  big_type.type = FFI_TYPE_STRUCT;
+  big_type.elements = big_elements;
+  big_elements[0] = big_elements[1] = &ffi_type_slong;
+  big_elements[2] = big_elements[3] = &ffi_type_slong;
+  big_elements[4] = NULL;
+
+  args[0] = &ffi_type_schar;	values[0] = &c;
+  args[1] = &ffi_type_sshort;	values[1] = &s;
+  args[2] = &ffi_type_sint;	values[2] = &i;
+  args[3] = &ffi_type_slong;	values[3] = &l;
+  args[4] = &ffi_type_float;	values[4] = &f;
+  args[5] = &ffi_type_double;	values[5] = &d;
+  args[6] = &pair_type;		values[6] = &p;
+  args[7] = &big_type;		values[7] = &b;
+  args[8] = &ffi_type_slong;	values[8] = &l7;
+  args[9] = &ffi_type_slong;	values[9] = &l8;
+  args[10] = &ffi_type_double;	values[10] = &d9;
+
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 11, &ffi_type_slong, args) == FFI_OK);
+  plan = ffi_plan_alloc (&cif);
+  CHECK(plan != NULL);
+
+  expected = (ffi_arg) many_mixed (c, s, i, l, f, d, p, b, l7, l8, d9);
+  res = 0;
+  ffi_call_plan (plan, FFI_FN(many_mixed), &res, values);
+  printf ("%ld %ld\n", (long) res, (long) expected);
+  CHECK(res == expected);
+
+  /* The same plan can be reused with different values.  */
+  c = 5;
+  b.d = 1000;
+  expected = (ffi_arg) many_mixed (c, s, i, l, f, d, p, b, l7, l8, d9);
+  ffi_call_plan (plan, FFI_FN(many_mixed), &res, values);
+  CHECK(res == expected);
+  ffi_plan_free (plan);
+
+  /* A struct returned in memory, with and without an rvalue.  */
+  args[0] = &ffi_type_slong;
+  args[1] = &ffi_type_double;
+  values[0] = &l;
+  values[1] = &d;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 2, &big_type, args) == FFI_OK);
+  plan = ffi_plan_alloc (&cif);
+  CHECK(plan != NULL);
+  memset (&r, 0, sizeof (r));
+  ffi_call_plan (plan, FFI_FN(make_big), &r, values);
+  CHECK(r.a == l && r.b == (long) d && r.c == l * 2 && r.d == -l);
+  ffi_call_plan (plan, FFI_FN(make_big), NULL, values);
+  ffi_plan_free (plan);
+
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 0, &ffi_type_void, NULL) == FFI_OK);
+  plan = ffi_plan_alloc (&cif);
+  CHECK(plan != NULL);
+  ffi_call_plan (plan, FFI_FN(zero), NULL, NULL);
+  CHECK(zero_calls == 1);
+  ffi_plan_free (plan);
+
+  exit(0);
+}
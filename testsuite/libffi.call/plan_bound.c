@@ -0,0 +1,114 @@
+/* Area:	ffi_plan_alloc_bound, ffi_call_plan
+   Purpose:	Check that plans with bound arguments pass the bound
+		values, for register, stack and struct arguments, and
+		ignore the corresponding avalue entries.
+   Limitations:	none.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+
+typedef struct
+{
+  double d;
+  long l;
+} pair;
+
+static long ABI_ATTR
+many (void *ctx, int i, pair p, long a, long b, long c, long d, long e,
+      double x, long stack)
+{
+  return (ctx != NULL) + i + (long) p.d + p.l + a + b + c + d + e
+    + (long) x + stack;
+}
+
+static pair ABI_ATTR
+make_pair (void *ctx, double d, long l)
+{
+  pair r;
+
+  r.d = d * 2;
+  r.l = l + (ctx != NULL);
+  return r;
+}
+
+int main (void)
+{
+  ffi_cif cif;
+  ffi_plan *plan;
+  ffi_type *args[MAX_ARGS];
+  void *values[MAX_ARGS], *bound[MAX_ARGS];
+  ffi_type pair_type;
+  ffi_type *pair_elements[3];
+  void *ctx = &cif;
+  int i = 5;
+  pair p = { 2.5, -7 }, r;
+  long a = 1, b = 2, c = 3, d = 4, e = 5, stack = 1000;
+  double x = 16.0;
+  ffi_arg res;
+  unsigned n;
+
+  pair_type.size = pair_type.alignment = 0;
+  pair_type.type = FFI_TYPE_STRUCT;
+  pair_type.elements = pair_elements;
+  pair_elements[0] = &ffi_type_double;
+  pair_elements[1] = &ffi_type_slong;
+  pair_elements[2] = NULL;
+
+  args[0] = &ffi_type_pointer;	values[0] = &ctx;
+  args[1] = &ffi_type_sint;	values[1] = &i;
+  args[2] = &pair_type;		values[2] = &p;
+  args[3] = &ffi_type_slong;	values[3] = &a;
+  args[4] = &ffi_type_slong;	values[4] = &b;
+  args[5] = &ffi_type_slong;	values[5] = &c;
+  args[6] = &ffi_type_slong;	values[6] = &d;
+  args[7] = &ffi_type_slong;	values[7] = &e;
+  args[8] = &ffi_type_double;	values[8] = &x;
+  args[9] = &ffi_type_slong;	values[9] = &stack;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 10, &ffi_type_slong, args) == FFI_OK);
+
+  /* Bind the context, the struct and the last (stack) argument.  */
+  for (n = 0; n < 10; n++)
+    bound[n] = NULL;
+  bound[0] = &ctx;
+  bound[2] = &p;
+  bound[9] = &stack;
+  plan = ffi_plan_alloc_bound (&cif, bound);
+  CHECK(plan != NULL);
+
+  /* The bound values were copied.  */
+  p.d = 0;
+  p.l = 0;
+  stack = 0;
+  values[0] = values[2] = values[9] = NULL;
+
+  for (i = 0; i < 3; i++)
+    {
+      a = i * 10;
+      x = i * 0.5;
+      ffi_call_plan (plan, FFI_FN(many), &res, values);
+      printf ("%ld\n", (long) res);
+      CHECK((long) res == 1 + i + 2 - 7 + a + b + c + d + e + (long) x
+	    + 1000);
+    }
+  ffi_plan_free (plan);
+
+  /* A struct return, with every argument bound.  */
+  args[1] = &ffi_type_double;
+  args[2] = &ffi_type_slong;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 3, &pair_type, args) == FFI_OK);
+  x = 4.0;
+  bound[0] = &ctx;
+  bound[1] = &x;
+  bound[2] = &a;
+  a = 41;
+  plan = ffi_plan_alloc_bound (&cif, bound);
+  CHECK(plan != NULL);
+  memset (&r, 0, sizeof (r));
+  ffi_call_plan (plan, FFI_FN(make_pair), &r, NULL);
+  CHECK(r.d == 8.0 && r.l == 42);
+  ffi_plan_free (plan);
+
+  exit(0);
+}
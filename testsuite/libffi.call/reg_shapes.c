@@ -0,0 +1,224 @@
+/* Area:	ffi_call
+   Purpose:	Check signatures whose arguments all fit in registers,
+		with mixed integer and SSE argument counts and each
+		scalar return type, and a variadic callee, whose address
+		ends in a zero byte, reached through a plain cif, a
+		variadic cif and a variadic tail.
+   Limitations:	none.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+#include <stdarg.h>
+
+static long ABI_ATTR
+gprs (long a, long b, long c, long d, long e, long f)
+{
+  return a + 2 * b + 3 * c + 4 * d + 5 * e + 6 * f;
+}
+
+static double ABI_ATTR
+mixed (double x1, signed char c, float x2, double x3, unsigned short s,
+       float x4, double x5, int i, double x6, void *p)
+{
+  return x1 + c + x2 + x3 + s + x4 + x5 + i + x6 + (p != NULL);
+}
+
+static float ABI_ATTR
+sses (float a, double b, float c, double d, float e, double f, float g,
+      double h)
+{
+  return a + b + c + d + e + f + g + h;
+}
+
+static signed char ABI_ATTR
+ret_sc (signed char c, double d)
+{
+  return (signed char) (c - (int) d);
+}
+
+static unsigned char ABI_ATTR
+ret_uc (unsigned char c)
+{
+  return (unsigned char) (c + 1);
+}
+
+static short ABI_ATTR
+ret_ss (short s, float f)
+{
+  return (short) (s * (int) f);
+}
+
+static unsigned int ABI_ATTR
+ret_ui (unsigned int u, unsigned int v, unsigned int w)
+{
+  return u ^ v ^ w;
+}
+
+static long long ABI_ATTR
+ret_ll (long long a, double b, double c, long long d)
+{
+  return a - (long long) b - (long long) c + d;
+}
+
+static void * ABI_ATTR
+ret_p (void *p, long off)
+{
+  return (char *) p + off;
+}
+
+/* The alignment gives the address a zero low byte, which a stale %al
+   would pass off as no vector registers.  */
+static double ABI_ATTR __attribute__((aligned (256)))
+va_sum (int n, ...)
+{
+  va_list ap;
+  double s = 0;
+
+  va_start (ap, n);
+  while (n-- > 0)
+    s += va_arg (ap, double);
+  va_end (ap);
+  return s;
+}
+
+static int void_calls;
+
+static void ABI_ATTR
+ret_v (int i)
+{
+  void_calls += i;
+}
+
+int main (void)
+{
+  ffi_cif cif;
+  ffi_var_cif vcif;
+  ffi_type *args[MAX_ARGS];
+  void *values[MAX_ARGS];
+  long l[6] = { 1, -2, 3, -4, 5, -6 };
+  double x1 = 1.5, x3 = -2.25, x5 = 100.0, x6 = 0.125, dres;
+  float x2 = 0.5f, x4 = -8.0f, fres;
+  signed char c = -7;
+  unsigned char uc = 254;
+  unsigned short us = 65000;
+  short ss = -300;
+  int i = -123456;
+  unsigned int u1 = 0xdeadbeef, u2 = 0x12345678, u3 = 0x0f0f0f0f;
+  long long ll1 = 0x123456789LL, ll2 = -5;
+  void *p = &cif, *pres;
+  ffi_arg res;
+  int n;
+
+  for (n = 0; n < 6; n++)
+    {
+      args[n] = &ffi_type_slong;
+      values[n] = &l[n];
+    }
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 6, &ffi_type_slong, args) == FFI_OK);
+  ffi_call(&cif, FFI_FN(gprs), &res, values);
+  CHECK((long) res == gprs (l[0], l[1], l[2], l[3], l[4], l[5]));
+
+  args[0] = &ffi_type_double;	values[0] = &x1;
+  args[1] = &ffi_type_schar;	values[1] = &c;
+  args[2] = &ffi_type_float;	values[2] = &x2;
+  args[3] = &ffi_type_double;	values[3] = &x3;
+  args[4] = &ffi_type_ushort;	values[4] = &us;
+  args[5] = &ffi_type_float;	values[5] = &x4;
+  args[6] = &ffi_type_double;	values[6] = &x5;
+  args[7] = &ffi_type_sint;	values[7] = &i;
+  args[8] = &ffi_type_double;	values[8] = &x6;
+  args[9] = &ffi_type_pointer;	values[9] = &p;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 10, &ffi_type_double, args) == FFI_OK);
+  ffi_call(&cif, FFI_FN(mixed), &dres, values);
+  printf ("%f\n", dres);
+  CHECK(dres == mixed (x1, c, x2, x3, us, x4, x5, i, x6, p));
+
+  args[0] = &ffi_type_float;	values[0] = &x2;
+  args[1] = &ffi_type_double;	values[1] = &x1;
+  args[2] = &ffi_type_float;	values[2] = &x4;
+  args[3] = &ffi_type_double;	values[3] = &x3;
+  args[4] = &ffi_type_float;	values[4] = &x2;
+  args[5] = &ffi_type_double;	values[5] = &x5;
+  args[6] = &ffi_type_float;	values[6] = &x4;
+  args[7] = &ffi_type_double;	values[7] = &x6;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 8, &ffi_type_float, args) == FFI_OK);
+  ffi_call(&cif, FFI_FN(sses), &fres, values);
+  CHECK(fres == sses (x2, x1, x4, x3, x2, x5, x4, x6));
+
+  args[0] = &ffi_type_schar;	values[0] = &c;
+  args[1] = &ffi_type_double;	values[1] = &x5;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 2, &ffi_type_schar, args) == FFI_OK);
+  ffi_call(&cif, FFI_FN(ret_sc), &res, values);
+  CHECK((signed char) res == ret_sc (c, x5));
+
+  args[0] = &ffi_type_uchar;	values[0] = &uc;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 1, &ffi_type_uchar, args) == FFI_OK);
+  ffi_call(&cif, FFI_FN(ret_uc), &res, values);
+  CHECK(res == ret_uc (uc));
+
+  args[0] = &ffi_type_sshort;	values[0] = &ss;
+  args[1] = &ffi_type_float;	values[1] = &x4;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 2, &ffi_type_sshort, args) == FFI_OK);
+  ffi_call(&cif, FFI_FN(ret_ss), &res, values);
+  CHECK((short) res == ret_ss (ss, x4));
+
+  args[0] = args[1] = args[2] = &ffi_type_uint;
+  values[0] = &u1;
+  values[1] = &u2;
+  values[2] = &u3;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 3, &ffi_type_uint, args) == FFI_OK);
+  ffi_call(&cif, FFI_FN(ret_ui), &res, values);
+  CHECK(res == ret_ui (u1, u2, u3));
+
+  args[0] = &ffi_type_sint64;	values[0] = &ll1;
+  args[1] = &ffi_type_double;	values[1] = &x5;
+  args[2] = &ffi_type_double;	values[2] = &x3;
+  args[3] = &ffi_type_sint64;	values[3] = &ll2;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 4, &ffi_type_sint64, args) == FFI_OK);
+  ffi_call(&cif, FFI_FN(ret_ll), &res, values);
+  CHECK((long long) res == ret_ll (ll1, x5, x3, ll2));
+
+  args[0] = &ffi_type_pointer;	values[0] = &p;
+  args[1] = &ffi_type_slong;	values[1] = &l[2];
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 2, &ffi_type_pointer, args) == FFI_OK);
+  ffi_call(&cif, FFI_FN(ret_p), &pres, values);
+  CHECK(pres == ret_p (p, l[2]));
+
+  args[0] = &ffi_type_sint;	values[0] = &i;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 1, &ffi_type_void, args) == FFI_OK);
+  ffi_call(&cif, FFI_FN(ret_v), NULL, values);
+  CHECK(void_calls == i);
+
+  /* A NULL rvalue discards the result.  */
+  args[0] = &ffi_type_uchar;	values[0] = &uc;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 1, &ffi_type_uchar, args) == FFI_OK);
+  ffi_call(&cif, FFI_FN(ret_uc), NULL, values);
+
+  n = 2;
+  args[0] = &ffi_type_sint;	values[0] = &n;
+  args[1] = &ffi_type_double;	values[1] = &x1;
+  args[2] = &ffi_type_double;	values[2] = &x3;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 3, &ffi_type_double, args) == FFI_OK);
+  ffi_call(&cif, FFI_FN(va_sum), &dres, values);
+  CHECK(dres == x1 + x3);
+
+  CHECK(ffi_prep_cif_var(&cif, ABI_NUM, 1, 3, &ffi_type_double, args)
+	== FFI_OK);
+  dres = 0;
+  ffi_call(&cif, FFI_FN(va_sum), &dres, values);
+  CHECK(dres == x1 + x3);
+
+  /* The tail has more SSE arguments than the fixed part.  */
+  n = 3;
+  args[3] = &ffi_type_double;	values[3] = &x5;
+  CHECK(ffi_prep_var_cif(&vcif, ABI_NUM, 1, &ffi_type_double, args)
+	== FFI_OK);
+  CHECK(ffi_prep_cif_var_tail(&cif, &vcif, 4, args) == FFI_OK);
+  dres = 0;
+  ffi_call(&cif, FFI_FN(va_sum), &dres, values);
+  CHECK(dres == x1 + x3 + x5);
+
+  exit(0);
+}
@@ -0,0 +1,167 @@
+/* Area:	ffi_prep_var_cif, ffi_prep_cif_var_tail
+   Purpose:	Check that cifs derived from a prepared fixed part match
+		those prepared by ffi_prep_cif_var, for variadic arguments
+		in registers and on the stack.
+   Limitations:	none.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+#include <stdarg.h>
+
+typedef struct
+{
+  long a, b, c;
+} triple;
+
+/* Sum the variadic arguments described by FMT: 'i' for int, 'l' for
+   long, 'd' for double and 't' for triple.  */
+static double
+sum (const char *fmt, ...)
+{
+  va_list ap;
+  double total = 0;
+  triple t;
+
+  va_start (ap, fmt);
+  for (; *fmt; fmt++)
+    switch (*fmt)
+      {
+      case 'i':
+	total += va_arg (ap, int);
+	break;
+      case 'l':
+	total += va_arg (ap, long);
+	break;
+      case 'd':
+	total += va_arg (ap, double);
+	break;
+      case 't':
+	t = va_arg (ap, triple);
+	total += t.a + t.b + t.c;
+	break;
+      }
+  va_end (ap);
+  return total;
+}
+
+static triple
+make (long base, ...)
+{
+  va_list ap;
+  triple t;
+
+  va_start (ap, base);
+  t.a = base + va_arg (ap, int);
+  t.b = base + va_arg (ap, long);
+  t.c = (long) (base + va_arg (ap, double));
+  va_end (ap);
+  return t;
+}
+
+static ffi_type triple_type;
+
+static void
+check_sum (const ffi_var_cif *vcif, const char *fmt)
+{
+  ffi_cif cif, ref;
+  ffi_type *args[MAX_ARGS];
+  void *values[MAX_ARGS];
+  union { int i; long l; double d; triple t; } storage[MAX_ARGS];
+  double expected = 0, res;
+  unsigned n;
+
+  args[0] = &ffi_type_pointer;
+  values[0] = &fmt;
+  for (n = 1; fmt[n - 1]; n++)
+    {
+      values[n] = &storage[n];
+      switch (fmt[n - 1])
+	{
+	case 'i':
+	  args[n] = &ffi_type_sint;
+	  storage[n].i = -(int) n;
+	  expected += storage[n].i;
+	  break;
+	case 'l':
+	  args[n] = &ffi_type_slong;
+	  storage[n].l = 1000L * n;
+	  expected += storage[n].l;
+	  break;
+	case 'd':
+	  args[n] = &ffi_type_double;
+	  storage[n].d = n + 0.5;
+	  expected += storage[n].d;
+	  break;
+	case 't':
+	  args[n] = &triple_type;
+	  storage[n].t.a = n;
+	  storage[n].t.b = 2 * n;
+	  storage[n].t.c = 3 * n;
+	  expected += 6 * n;
+	  break;
+	}
+    }
+
+  CHECK(ffi_prep_cif_var_tail (&cif, vcif, n, args) == FFI_OK);
+  CHECK(ffi_prep_cif_var (&ref, ABI_NUM, 1, n, &ffi_type_double, args)
+	== FFI_OK);
+  CHECK(cif.nargs == ref.nargs && cif.arg_types == ref.arg_types);
+  CHECK(cif.bytes == ref.bytes && cif.flags == ref.flags);
+
+  ffi_call (&cif, FFI_FN(sum), &res, values);
+  CHECK(res == expected);
+}
+
+int main (void)
+{
+  ffi_var_cif vcif;
+  ffi_cif cif;
+  ffi_type *args[MAX_ARGS];
+  ffi_type *triple_elements[4];
+  void *values[MAX_ARGS];
+  long base = 10, l = 20;
+  int i = 5;
+  double d = 2.5;
+  triple t;
+
+  triple_type.size = triple_type.alignment = 0;
+  triple_type.type = FFI_TYPE_STRUCT;
+  triple_type.elements = triple_elements;
+  triple_elements[0] = triple_elements[1] = triple_elements[2]
+    = &ffi_type_slong;
+  triple_elements[3] = NULL;
+
+  args[0] = &ffi_type_pointer;
+  CHECK(ffi_prep_var_cif (&vcif, ABI_NUM, 1, &ffi_type_double, args)
+	== FFI_OK);
+
+  check_sum (&vcif, "");
+  check_sum (&vcif, "i");
+  check_sum (&vcif, "did");
+  check_sum (&vcif, "ldtd");
+  /* Enough integers and doubles to spill to the stack.  */
+  check_sum (&vcif, "iiiiillld");
+  check_sum (&vcif, "ddddddddddid");
+  check_sum (&vcif, "tttdddddddddtl");
+
+  /* A struct returned in memory takes an integer register before the
+     fixed arguments.  */
+  args[0] = &ffi_type_slong;
+  CHECK(ffi_prep_var_cif (&vcif, ABI_NUM, 1, &triple_type, args) == FFI_OK);
+  args[1] = &ffi_type_sint;
+  args[2] = &ffi_type_slong;
+  args[3] = &ffi_type_double;
+  CHECK(ffi_prep_cif_var_tail (&cif, &vcif, 4, args) == FFI_OK);
+  values[0] = &base;
+  values[1] = &i;
+  values[2] = &l;
+  values[3] = &d;
+  ffi_call (&cif, FFI_FN(make), &t, values);
+  CHECK(t.a == 15 && t.b == 30 && t.c == 12);
+
+  printf ("ok\n");
+  /* { dg-output "ok" } */
+  exit (0);
+}
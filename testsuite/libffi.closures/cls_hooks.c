@@ -0,0 +1,218 @@
+/* Area:	ffi_cif_set_hooks
+   Purpose:	Check that the hooks of a cif run around its calls and
+		closures, in order, and that removing the hooks or
+		preparing the cif again stops them.
+   Limitations:	Targets without hooks only check that FFI_BAD_ABI is
+		returned.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+
+typedef struct
+{
+  long a, b, c;
+} triple;
+
+static char trace[64];
+static int trace_len;
+
+static void
+record (char c)
+{
+  CHECK(trace_len < (int) sizeof (trace) - 1);
+  trace[trace_len++] = c;
+  trace[trace_len] = 0;
+}
+
+static void
+before_call (ffi_cif *cif, void *data)
+{
+  (void) cif;
+  CHECK(*(int *) data == 42);
+  record ('[');
+}
+
+static void
+after_call (ffi_cif *cif, void *data)
+{
+  (void) cif;
+  (void) data;
+  record (']');
+}
+
+static void
+before_closure (ffi_cif *cif, void *data)
+{
+  (void) cif;
+  (void) data;
+  record ('<');
+}
+
+static void
+after_closure (ffi_cif *cif, void *data)
+{
+  (void) cif;
+  (void) data;
+  record ('>');
+}
+
+static int
+add (int a, int b)
+{
+  record ('f');
+  return a + b;
+}
+
+static triple
+make (long a)
+{
+  triple t;
+
+  record ('f');
+  t.a = a;
+  t.b = a + 1;
+  t.c = a + 2;
+  return t;
+}
+
+static void
+add_handler (ffi_cif *cif, void *resp, void **args, void *userdata)
+{
+  (void) cif;
+  (void) userdata;
+  record ('h');
+  *(ffi_arg *) resp = *(int *) args[0] + *(int *) args[1];
+}
+
+static void
+make_handler (ffi_cif *cif, void *resp, void **args, void *userdata)
+{
+  triple *t = resp;
+
+  (void) cif;
+  (void) userdata;
+  record ('h');
+  t->a = t->b = t->c = *(long *) args[0];
+}
+
+static void
+reset (void)
+{
+  trace_len = 0;
+  trace[0] = 0;
+}
+
+int main (void)
+{
+  ffi_cif cif_add, cif_make;
+  ffi_type *add_args[2], *make_args[1];
+  ffi_type triple_type;
+  ffi_type *triple_elements[4];
+  void *values[2];
+  ffi_hooks hooks;
+  ffi_closure *cl_add, *cl_make;
+  void *code_add, *code_make;
+  ffi_plan *plan;
+  ffi_status status;
+  ffi_arg res;
+  int a = 2, b = 3, data = 42;
+  long l = 7;
+  triple t;
+
+  triple_type.size = triple_type.alignment = 0;
+  triple_type.type = FFI_TYPE_STRUCT;
+  triple_type.elements = triple_elements;
+  triple_elements[0] = triple_elements[1] = triple_elements[2]
+    = &ffi_type_slong;
+  triple_elements[3] = NULL;
+
+  add_args[0] = add_args[1] = &ffi_type_sint;
+  CHECK(ffi_prep_cif(&cif_add, ABI_NUM, 2, &ffi_type_sint, add_args)
+	== FFI_OK);
+  make_args[0] = &ffi_type_slong;
+  CHECK(ffi_prep_cif(&cif_make, ABI_NUM, 1, &triple_type, make_args)
+	== FFI_OK);
+
+  hooks.before_call = before_call;
+  hooks.after_call = after_call;
+  hooks.before_closure = before_closure;
+  hooks.after_closure = after_closure;
+  hooks.data = &data;
+  status = ffi_cif_set_hooks (&cif_add, &hooks);
+  if (status == FFI_BAD_ABI)
+    /* Not supported by this target.  */
+    exit (0);
+  CHECK(status == FFI_OK);
+  CHECK(ffi_cif_set_hooks (&cif_make, &hooks) == FFI_OK);
+
+  /* Calls.  */
+  values[0] = &a;
+  values[1] = &b;
+  ffi_call (&cif_add, FFI_FN(add), &res, values);
+  CHECK((int) res == 5);
+  values[0] = &l;
+  ffi_call (&cif_make, FFI_FN(make), &t, values);
+  CHECK(t.a == 7 && t.c == 9);
+  CHECK(strcmp (trace, "[f][f]") == 0);
+
+  /* Plans run the hooks too.  */
+  reset ();
+  plan = ffi_plan_alloc (&cif_add);
+  CHECK(plan != NULL);
+  values[0] = &a;
+  ffi_call_plan (plan, FFI_FN(add), &res, values);
+  CHECK((int) res == 5);
+  ffi_plan_free (plan);
+  CHECK(strcmp (trace, "[f]") == 0);
+
+  /* Closures.  */
+  reset ();
+  cl_add = ffi_closure_alloc (sizeof (ffi_closure), &code_add);
+  cl_make = ffi_closure_alloc (sizeof (ffi_closure), &code_make);
+  CHECK(cl_add != NULL && cl_make != NULL);
+  CHECK(ffi_prep_closure_loc (cl_add, &cif_add, add_handler, NULL,
+			      code_add) == FFI_OK);
+  CHECK(ffi_prep_closure_loc (cl_make, &cif_make, make_handler, NULL,
+			      code_make) == FFI_OK);
+  CHECK(((int (*)(int, int)) code_add) (4, 5) == 9);
+  t = ((triple (*)(long)) code_make) (11);
+  CHECK(t.a == 11 && t.c == 11);
+  CHECK(strcmp (trace, "<h><h>") == 0);
+
+  /* A call through a closure runs both sets of hooks.  */
+  reset ();
+  values[0] = &a;
+  ffi_call (&cif_add, FFI_FN(code_add), &res, values);
+  CHECK((int) res == 5);
+  CHECK(strcmp (trace, "[<h>]") == 0);
+
+  /* Typed closures cannot run hooks.  */
+  CHECK(ffi_prep_typed_closure_loc (cl_add, &cif_add, FFI_FN(add), NULL,
+				    code_add) == FFI_BAD_ABI);
+
+  /* Removing the hooks, or preparing the cif again, stops them.  */
+  reset ();
+  CHECK(ffi_cif_set_hooks (&cif_add, NULL) == FFI_OK);
+  ffi_call (&cif_add, FFI_FN(add), &res, values);
+  CHECK(ffi_prep_cif(&cif_make, ABI_NUM, 1, &triple_type, make_args)
+	== FFI_OK);
+  values[0] = &l;
+  ffi_call (&cif_make, FFI_FN(make), &t, values);
+  CHECK(strcmp (trace, "ff") == 0);
+
+  /* Setting only some of the hooks.  */
+  reset ();
+  memset (&hooks, 0, sizeof (hooks));
+  hooks.after_closure = after_closure;
+  CHECK(ffi_cif_set_hooks (&cif_add, &hooks) == FFI_OK);
+  CHECK(((int (*)(int, int)) code_add) (1, 1) == 2);
+  CHECK(strcmp (trace, "h>") == 0);
+
+  ffi_closure_free (cl_add);
+  ffi_closure_free (cl_make);
+  printf ("ok\n");
+  /* { dg-output "ok" } */
+  exit (0);
+}
@@ -0,0 +1,196 @@
+/* Area:	ffi_prep_packed_closure_loc
+   Purpose:	Check that a packed closure receives its register, stack
+		and struct arguments in a block laid out as reported by
+		ffi_get_packed_offsets, and that it can return a struct
+		in memory, also when every argument is a scalar that
+		comes in a register.
+   Limitations:	Targets without packed closures only check that
+		FFI_BAD_ABI is returned.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+
+typedef struct
+{
+  double d;
+  int i;
+} mixed_pair;
+
+typedef struct
+{
+  long a, b, c;
+} triple;
+
+/* The packed block of the first closure's arguments.  */
+struct args
+{
+  signed char c;
+  mixed_pair mp;
+  float f;
+  long l[6];
+  triple t;
+  double d;
+};
+
+static struct args expected;
+
+static void
+packed_fn (ffi_cif *cif, void *resp, void *args, void *userdata)
+{
+  struct args *a = args;
+  size_t size;
+
+  CHECK(ffi_get_packed_offsets (cif, NULL, &size) == FFI_OK);
+  CHECK(size == sizeof (struct args));
+  CHECK(memcmp (&a->c, &expected.c, sizeof (a->c)) == 0);
+  CHECK(a->mp.d == expected.mp.d && a->mp.i == expected.mp.i);
+  CHECK(a->f == expected.f);
+  CHECK(memcmp (a->l, expected.l, sizeof (a->l)) == 0);
+  CHECK(memcmp (&a->t, &expected.t, sizeof (a->t)) == 0);
+  CHECK(a->d == expected.d);
+
+  *(ffi_arg *) resp = *(int *) userdata + a->c + a->l[5];
+}
+
+static void
+triple_fn (ffi_cif *cif, void *resp, void *args, void *userdata)
+{
+  triple *r = resp;
+  long *a = args;
+
+  (void) cif;
+  (void) userdata;
+  r->a = a[0];
+  r->b = a[1];
+  r->c = a[0] + a[1];
+}
+
+/* The packed block of the closure whose arguments all come in
+   registers.  */
+struct scalar_args
+{
+  short s;
+  float f;
+  int i;
+  double d;
+  void *p;
+  unsigned char uc;
+};
+
+static void
+scalar_fn (ffi_cif *cif, void *resp, void *args, void *userdata)
+{
+  struct scalar_args *a = args;
+  size_t size;
+
+  CHECK(ffi_get_packed_offsets (cif, NULL, &size) == FFI_OK);
+  CHECK(size == sizeof (struct scalar_args));
+  CHECK(a->s == -12 && a->f == 1.5f && a->i == 70000 && a->d == -0.5);
+  CHECK(a->p == userdata && a->uc == 200);
+  *(ffi_arg *) resp = (signed char) (a->s + a->i);
+}
+
+typedef int (*packed_fn_t) (signed char, mixed_pair, float, long, long,
+			    long, long, long, long, triple, double);
+typedef triple (*triple_fn_t) (long, long);
+typedef signed char (*scalar_fn_t) (short, float, int, double, void *,
+				    unsigned char);
+
+int main (void)
+{
+  ffi_cif cif, cif_triple, cif_scalar;
+  ffi_type *args[MAX_ARGS];
+  ffi_type pair_type, triple_type;
+  ffi_type *pair_elements[3], *triple_elements[4];
+  ffi_closure *pcl, *pcl_triple, *pcl_scalar;
+  void *code, *code_triple, *code_scalar;
+  ffi_status status;
+  int base = 100;
+  triple t;
+  unsigned i;
+
+  pcl = ffi_closure_alloc (sizeof (ffi_closure), &code);
+  pcl_triple = ffi_closure_alloc (sizeof (ffi_closure), &code_triple);
+  pcl_scalar = ffi_closure_alloc (sizeof (ffi_closure), &code_scalar);
+  CHECK(pcl != NULL && pcl_triple != NULL && pcl_scalar != NULL);
+
+  pair_type.size = pair_type.alignment = 0;
+  pair_type.type = FFI_TYPE_STRUCT;
+  pair_type.elements = pair_elements;
+  pair_elements[0] = &ffi_type_double;
+  pair_elements[1] = &ffi_type_sint;
+  pair_elements[2] = NULL;
+
+  triple_type.size = triple_type.alignment = 0;
+  triple_type.type = FFI_TYPE_STRUCT;
+  triple_type.elements = triple_elements;
+  triple_elements[0] = triple_elements[1] = triple_elements[2]
+    = &ffi_type_slong;
+  triple_elements[3] = NULL;
+
+  args[0] = &ffi_type_schar;
+  args[1] = &pair_type;
+  args[2] = &ffi_type_float;
+  for (i = 3; i < 9; i++)
+    args[i] = &ffi_type_slong;
+  args[9] = &triple_type;
+  args[10] = &ffi_type_double;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 11, &ffi_type_sint, args) == FFI_OK);
+
+  status = ffi_prep_packed_closure_loc (pcl, &cif, packed_fn, &base, code);
+  if (status == FFI_BAD_ABI)
+    {
+      /* Not supported by this target.  */
+      ffi_closure_free (pcl);
+      ffi_closure_free (pcl_triple);
+      ffi_closure_free (pcl_scalar);
+      exit (0);
+    }
+  CHECK(status == FFI_OK);
+
+  memset (&expected, 0, sizeof (expected));
+  expected.c = -7;
+  expected.mp.d = 2.5;
+  expected.mp.i = -3;
+  expected.f = 0.25f;
+  for (i = 0; i < 6; i++)
+    expected.l[i] = (i + 1) * 1000;
+  expected.t.a = 1;
+  expected.t.b = 2;
+  expected.t.c = 3;
+  expected.d = 1e10;
+
+  CHECK(((packed_fn_t) code) (expected.c, expected.mp, expected.f,
+			      expected.l[0], expected.l[1], expected.l[2],
+			      expected.l[3], expected.l[4], expected.l[5],
+			      expected.t, expected.d) == 100 - 7 + 6000);
+
+  args[0] = args[1] = &ffi_type_slong;
+  CHECK(ffi_prep_cif(&cif_triple, ABI_NUM, 2, &triple_type, args) == FFI_OK);
+  CHECK(ffi_prep_packed_closure_loc (pcl_triple, &cif_triple, triple_fn,
+				     NULL, code_triple) == FFI_OK);
+  t = ((triple_fn_t) code_triple) (40, 2);
+  CHECK(t.a == 40 && t.b == 2 && t.c == 42);
+
+  args[0] = &ffi_type_sshort;
+  args[1] = &ffi_type_float;
+  args[2] = &ffi_type_sint;
+  args[3] = &ffi_type_double;
+  args[4] = &ffi_type_pointer;
+  args[5] = &ffi_type_uchar;
+  CHECK(ffi_prep_cif(&cif_scalar, ABI_NUM, 6, &ffi_type_schar, args)
+	== FFI_OK);
+  CHECK(ffi_prep_packed_closure_loc (pcl_scalar, &cif_scalar, scalar_fn,
+				     &base, code_scalar) == FFI_OK);
+  CHECK(((scalar_fn_t) code_scalar) (-12, 1.5f, 70000, -0.5, &base, 200)
+	== (signed char) (70000 - 12));
+
+  ffi_closure_free (pcl);
+  ffi_closure_free (pcl_triple);
+  ffi_closure_free (pcl_scalar);
+  printf ("ok\n");
+  /* { dg-output "ok" } */
+  exit (0);
+}
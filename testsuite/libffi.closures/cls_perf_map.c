@@ -0,0 +1,97 @@
+/* Area:	closure creation
+   Purpose:	Check that closure trampolines are named in the perf map
+		file when LIBFFI_PERF_MAP is set, and that a child of
+		fork names its closures in its own file.
+   Limitations:	Linux only.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run { target *-*-linux* } } */
+#include "ffitest.h"
+#include <unistd.h>
+#include <sys/wait.h>
+
+static void
+handler (ffi_cif *cif, void *resp, void **args, void *userdata)
+{
+  (void) cif;
+  (void) userdata;
+  *(ffi_arg *) resp = *(int *) args[0] + 1;
+}
+
+/* Whether the perf map file of PID names CODE, or -1 if there is no
+   such file.  */
+
+static int
+map_has (pid_t pid, void *code)
+{
+  char name[32], line[256], want[32];
+  FILE *f;
+  int found = 0;
+
+  snprintf (name, sizeof (name), "/tmp/perf-%d.map", (int) pid);
+  f = fopen (name, "r");
+  if (f == NULL)
+    return -1;
+  snprintf (want, sizeof (want), "%lx ", (unsigned long) (uintptr_t) code);
+  while (fgets (line, sizeof (line), f) != NULL)
+    if (strncmp (line, want, strlen (want)) == 0
+	&& strstr (line, "ffi_closure") != NULL)
+      found = 1;
+  fclose (f);
+  return found;
+}
+
+int main (void)
+{
+  ffi_cif cif;
+  ffi_type *args[1];
+  ffi_closure *cl, *child_cl;
+  void *code, *child_code;
+  char name[32], child_name[32];
+  pid_t pid;
+  int status;
+
+  /* The variable is read when the first closure is prepared.  */
+  setenv ("LIBFFI_PERF_MAP", "1", 1);
+  snprintf (name, sizeof (name), "/tmp/perf-%d.map", (int) getpid ());
+  unlink (name);
+
+  args[0] = &ffi_type_sint;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 1, &ffi_type_sint, args) == FFI_OK);
+  cl = ffi_closure_alloc (sizeof (ffi_closure), &code);
+  CHECK(cl != NULL);
+  CHECK(ffi_prep_closure_loc (cl, &cif, handler, NULL, code) == FFI_OK);
+  CHECK(((int (*)(int)) code) (41) == 42);
+
+  status = map_has (getpid (), code);
+  if (status < 0)
+    /* Not supported by this target.  */
+    exit (0);
+  CHECK(status == 1);
+
+  /* The child inherits the descriptor of this process's file, but
+     must write to its own.  */
+  pid = fork ();
+  CHECK(pid >= 0);
+  if (pid == 0)
+    {
+      child_cl = ffi_closure_alloc (sizeof (ffi_closure), &child_code);
+      if (child_cl == NULL
+	  || ffi_prep_closure_loc (child_cl, &cif, handler, NULL,
+				   child_code) != FFI_OK)
+	_exit (1);
+      _exit (map_has (getpid (), child_code) == 1
+	     && map_has (getppid (), child_code) == 0 ? 0 : 1);
+    }
+  CHECK(waitpid (pid, &status, 0) == pid);
+  snprintf (child_name, sizeof (child_name), "/tmp/perf-%d.map", (int) pid);
+  unlink (child_name);
+  unlink (name);
+  CHECK(WIFEXITED (status) && WEXITSTATUS (status) == 0);
+
+  ffi_closure_free (cl);
+  printf ("ok\n");
+  /* { dg-output "ok" } */
+  exit (0);
+}
@@ -0,0 +1,147 @@
+/* Area:	ffi_prep_queued_closure_loc, ffi_closure_queue_run
+   Purpose:	Check that calls of queued closures from other threads
+		run on the owner thread, both waiting for the result and
+		not, and that calls on the owner thread run at once.
+   Limitations:	Targets without threads only check that the queue
+		cannot be allocated.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run { target { ! *-*-mingw* } } } */
+#include "ffitest.h"
+#include <pthread.h>
+#include <unistd.h>
+
+#define NTHREADS 4
+#define NCALLS 50
+
+typedef int (*add_t) (int, int);
+typedef void (*log_t) (int, double);
+
+static pthread_t owner;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static int wake_pipe[2];
+static int threads_done;
+static long logged;
+static double logged_sum;
+static add_t add_code;
+static log_t log_code;
+
+static void
+notify (ffi_closure_queue *queue, void *data)
+{
+  char c = 0;
+
+  (void) queue;
+  (void) data;
+  CHECK(write (wake_pipe[1], &c, 1) == 1);
+}
+
+static void
+add_fn (ffi_cif *cif, void *resp, void **args, void *userdata)
+{
+  (void) cif;
+  CHECK(pthread_equal (pthread_self (), owner));
+  *(ffi_arg *) resp = *(int *) args[0] + *(int *) args[1] + *(int *) userdata;
+}
+
+static void
+log_fn (ffi_cif *cif, void *resp, void **args, void *userdata)
+{
+  (void) cif;
+  (void) resp;
+  (void) userdata;
+  CHECK(pthread_equal (pthread_self (), owner));
+  logged++;
+  logged_sum += *(int *) args[0] + *(double *) args[1];
+}
+
+static void *
+worker (void *arg)
+{
+  int t = (int) (long) arg, i;
+
+  for (i = 0; i < NCALLS; i++)
+    {
+      CHECK(add_code (t, i) == t + i + 1000);
+      log_code (i, 0.5);
+    }
+
+  pthread_mutex_lock (&lock);
+  threads_done++;
+  pthread_mutex_unlock (&lock);
+  notify (NULL, NULL);
+  return NULL;
+}
+
+int main (void)
+{
+  ffi_cif cif_add, cif_log;
+  ffi_type *add_args[2], *log_args[2];
+  ffi_queued_closure *add_cl, *log_cl;
+  ffi_closure_queue *queue;
+  pthread_t threads[NTHREADS];
+  int base = 1000, done, i;
+  char c;
+
+  owner = pthread_self ();
+  CHECK(pipe (wake_pipe) == 0);
+  queue = ffi_closure_queue_alloc (notify, NULL);
+  if (queue == NULL)
+    /* No threads on this target.  */
+    exit (0);
+
+  add_cl = ffi_closure_alloc (sizeof (ffi_queued_closure),
+			      (void **) &add_code);
+  log_cl = ffi_closure_alloc (sizeof (ffi_queued_closure),
+			      (void **) &log_code);
+  CHECK(add_cl != NULL && log_cl != NULL);
+
+  add_args[0] = add_args[1] = &ffi_type_sint;
+  CHECK(ffi_prep_cif(&cif_add, ABI_NUM, 2, &ffi_type_sint, add_args)
+	== FFI_OK);
+  log_args[0] = &ffi_type_sint;
+  log_args[1] = &ffi_type_double;
+  CHECK(ffi_prep_cif(&cif_log, ABI_NUM, 2, &ffi_type_void, log_args)
+	== FFI_OK);
+
+  CHECK(ffi_prep_queued_closure_loc (add_cl, &cif_add, add_fn, &base, queue,
+				     FFI_QUEUED_NOWAIT, add_code)
+	== FFI_BAD_TYPEDEF);
+  CHECK(ffi_prep_queued_closure_loc (add_cl, &cif_add, add_fn, &base, queue,
+				     0, add_code) == FFI_OK);
+  CHECK(ffi_prep_queued_closure_loc (log_cl, &cif_log, log_fn, NULL, queue,
+				     FFI_QUEUED_NOWAIT, log_code) == FFI_OK);
+
+  /* On the owner thread, calls are not queued.  */
+  CHECK(add_code (1, 2) == 1003);
+  log_code (1, 0.5);
+  CHECK(logged == 1);
+
+  for (i = 0; i < NTHREADS; i++)
+    CHECK(pthread_create (&threads[i], NULL, worker, (void *) (long) i) == 0);
+
+  do
+    {
+      CHECK(read (wake_pipe[0], &c, 1) == 1);
+      ffi_closure_queue_run (queue);
+      pthread_mutex_lock (&lock);
+      done = threads_done;
+      pthread_mutex_unlock (&lock);
+    }
+  while (done < NTHREADS);
+
+  for (i = 0; i < NTHREADS; i++)
+    CHECK(pthread_join (threads[i], NULL) == 0);
+  ffi_closure_queue_run (queue);
+  CHECK(logged == 1 + NTHREADS * NCALLS);
+  CHECK(logged_sum == 1.5 + NTHREADS * (NCALLS * (NCALLS - 1) / 2
+					+ NCALLS * 0.5));
+
+  ffi_closure_queue_free (queue);
+  ffi_closure_free (add_cl);
+  ffi_closure_free (log_cl);
+  printf ("ok\n");
+  /* { dg-output "ok" } */
+  exit (0);
+}
@@ -0,0 +1,146 @@
+/* Area:	closure_call
+   Purpose:	Check closures whose arguments all fit in registers, with
+		each number of integer arguments, SSE argument counts on
+		both sides of each entry point, and the promotion of
+		narrow integer return values.
+   Limitations:	none.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+
+/* Sum the arguments, whatever their types.  */
+static void
+sum_fn (ffi_cif *cif, void *resp, void **args, void *userdata)
+{
+  double sum = 0;
+  unsigned i;
+
+  for (i = 0; i < cif->nargs; i++)
+    switch (cif->arg_types[i]->type)
+      {
+      case FFI_TYPE_SINT8:
+	sum += *(signed char *) args[i];
+	break;
+      case FFI_TYPE_UINT16:
+	sum += *(unsigned short *) args[i];
+	break;
+      case FFI_TYPE_SINT32:
+	sum += *(int *) args[i];
+	break;
+      case FFI_TYPE_SINT64:
+	sum += *(long long *) args[i];
+	break;
+      case FFI_TYPE_FLOAT:
+	sum += *(float *) args[i];
+	break;
+      case FFI_TYPE_DOUBLE:
+	sum += *(double *) args[i];
+	break;
+      default:
+	abort ();
+      }
+  sum += *(int *) userdata;
+
+  switch (cif->rtype->type)
+    {
+    case FFI_TYPE_SINT8:
+      *(ffi_sarg *) resp = (signed char) sum;
+      break;
+    case FFI_TYPE_UINT8:
+      *(ffi_arg *) resp = (unsigned char) sum;
+      break;
+    case FFI_TYPE_SINT16:
+      *(ffi_sarg *) resp = (short) sum;
+      break;
+    case FFI_TYPE_SINT64:
+      *(long long *) resp = (long long) sum;
+      break;
+    case FFI_TYPE_FLOAT:
+      *(float *) resp = (float) sum;
+      break;
+    case FFI_TYPE_DOUBLE:
+      *(double *) resp = sum;
+      break;
+    default:
+      abort ();
+    }
+}
+
+typedef long long (*gprs_fn) (int, long long, int, long long, int,
+			      long long);
+typedef double (*sse3_fn) (double, float, double);
+typedef float (*sse5_fn) (float, double, signed char, float, double,
+			  double);
+typedef double (*sse8_fn) (int, double, double, double, double, double,
+			   double, double, double);
+typedef signed char (*sc_fn) (signed char, double);
+typedef unsigned char (*uc_fn) (int);
+typedef short (*ss_fn) (unsigned short, float);
+
+static void *
+make_closure (ffi_cif *cif, unsigned nargs, ffi_type *rtype,
+	      ffi_type **args, int *userdata)
+{
+  void *code;
+  ffi_closure *pcl = ffi_closure_alloc (sizeof (ffi_closure), &code);
+
+  CHECK(pcl != NULL);
+  CHECK(ffi_prep_cif(cif, ABI_NUM, nargs, rtype, args) == FFI_OK);
+  CHECK(ffi_prep_closure_loc(pcl, cif, sum_fn, userdata, code) == FFI_OK);
+  return code;
+}
+
+int main (void)
+{
+  ffi_cif cif[7];
+  ffi_type *args[MAX_ARGS];
+  int zero = 0, one = 1;
+  void *code;
+  int i;
+
+  for (i = 0; i < 6; i++)
+    args[i] = i % 2 ? &ffi_type_sint64 : &ffi_type_sint;
+  code = make_closure (&cif[0], 6, &ffi_type_sint64, args, &zero);
+  CHECK(((gprs_fn) code) (1, -2, 3, 1LL << 40, 5, -6) == (1LL << 40) + 1);
+
+  args[0] = &ffi_type_double;
+  args[1] = &ffi_type_float;
+  args[2] = &ffi_type_double;
+  code = make_closure (&cif[1], 3, &ffi_type_double, args, &one);
+  CHECK(((sse3_fn) code) (0.5, 0.25f, 100.0) == 101.75);
+
+  args[0] = &ffi_type_float;
+  args[1] = &ffi_type_double;
+  args[2] = &ffi_type_sint8;
+  args[3] = &ffi_type_float;
+  args[4] = &ffi_type_double;
+  args[5] = &ffi_type_double;
+  code = make_closure (&cif[2], 6, &ffi_type_float, args, &zero);
+  CHECK(((sse5_fn) code) (1.5f, 2.0, -4, 0.25f, 8.0, -0.75) == 7.0f);
+
+  args[0] = &ffi_type_sint;
+  for (i = 1; i < 9; i++)
+    args[i] = &ffi_type_double;
+  code = make_closure (&cif[3], 9, &ffi_type_double, args, &one);
+  CHECK(((sse8_fn) code) (10, 1, 2, 3, 4, 5, 6, 7, 8) == 47.0);
+
+  args[0] = &ffi_type_sint8;
+  args[1] = &ffi_type_double;
+  code = make_closure (&cif[4], 2, &ffi_type_sint8, args, &zero);
+  CHECK(((sc_fn) code) (-100, -20.0) == -120);
+
+  args[0] = &ffi_type_sint;
+  code = make_closure (&cif[5], 1, &ffi_type_uint8, args, &one);
+  CHECK(((uc_fn) code) (254) == 255);
+
+  args[0] = &ffi_type_uint16;
+  args[1] = &ffi_type_float;
+  code = make_closure (&cif[6], 2, &ffi_type_sint16, args, &zero);
+  CHECK(((ss_fn) code) (40000, -50000.0f) == -10000);
+
+  printf ("ok\n");
+  /* { dg-output "ok" } */
+  exit(0);
+}
@@ -0,0 +1,144 @@
+/* Area:	ffi_cif_set_counting, ffi_cif_stats_foreach
+   Purpose:	Check that the calls and closure invocations of counted
+		cifs are counted, and that counting stops when asked and
+		counts are cleared when the cif is prepared again.
+   Limitations:	Targets that cannot count only check that FFI_BAD_ABI
+		is returned.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+
+static ffi_cif cif_add, cif_neg;
+static ffi_cif_stats add_stats, neg_stats;
+static int hooked;
+
+static int
+add (int a, int b)
+{
+  return a + b;
+}
+
+static void
+add_handler (ffi_cif *cif, void *resp, void **args, void *userdata)
+{
+  (void) cif;
+  (void) userdata;
+  *(ffi_arg *) resp = *(int *) args[0] + *(int *) args[1];
+}
+
+static double
+neg (double d)
+{
+  return -d;
+}
+
+static void
+after_call (ffi_cif *cif, void *data)
+{
+  (void) cif;
+  (void) data;
+  hooked++;
+}
+
+static void
+collect (const ffi_cif_stats *stats, void *data)
+{
+  CHECK(*(int *) data == 42);
+  if (stats->cif == &cif_add)
+    add_stats = *stats;
+  else if (stats->cif == &cif_neg)
+    neg_stats = *stats;
+}
+
+static void
+refresh (void)
+{
+  int data = 42;
+
+  memset (&add_stats, 0, sizeof (add_stats));
+  memset (&neg_stats, 0, sizeof (neg_stats));
+  ffi_cif_stats_foreach (collect, &data);
+}
+
+int main (void)
+{
+  ffi_type *add_args[2], *neg_args[1];
+  void *values[2];
+  ffi_closure *cl;
+  void *code;
+  ffi_hooks hooks;
+  ffi_status status;
+  ffi_arg res;
+  int a = 2, b = 3, i;
+  double d = 1.5, r;
+
+  add_args[0] = add_args[1] = &ffi_type_sint;
+  CHECK(ffi_prep_cif(&cif_add, ABI_NUM, 2, &ffi_type_sint, add_args)
+	== FFI_OK);
+  neg_args[0] = &ffi_type_double;
+  CHECK(ffi_prep_cif(&cif_neg, ABI_NUM, 1, &ffi_type_double, neg_args)
+	== FFI_OK);
+
+  status = ffi_cif_set_counting (&cif_add, 1);
+  if (status == FFI_BAD_ABI)
+    /* Not supported by this target.  */
+    exit (0);
+  CHECK(status == FFI_OK);
+
+  /* Uncounted cifs do not show up.  */
+  values[0] = &d;
+  ffi_call (&cif_neg, FFI_FN(neg), &r, values);
+  CHECK(r == -1.5);
+  refresh ();
+  CHECK(add_stats.cif == &cif_add && add_stats.calls == 0);
+  CHECK(neg_stats.cif == NULL);
+
+  values[0] = &a;
+  values[1] = &b;
+  for (i = 0; i < 10; i++)
+    ffi_call (&cif_add, FFI_FN(add), &res, values);
+  CHECK((int) res == 5);
+
+  cl = ffi_closure_alloc (sizeof (ffi_closure), &code);
+  CHECK(cl != NULL);
+  CHECK(ffi_prep_closure_loc (cl, &cif_add, add_handler, NULL, code)
+	== FFI_OK);
+  for (i = 0; i < 3; i++)
+    CHECK(((int (*)(int, int)) code) (i, 1) == i + 1);
+
+  refresh ();
+  CHECK(add_stats.calls == 10);
+  CHECK(add_stats.closure_calls == 3);
+  CHECK(add_stats.ticks > 0);
+
+  /* Counting and hooks can be used together.  */
+  CHECK(ffi_cif_set_counting (&cif_neg, 1) == FFI_OK);
+  memset (&hooks, 0, sizeof (hooks));
+  hooks.after_call = after_call;
+  CHECK(ffi_cif_set_hooks (&cif_neg, &hooks) == FFI_OK);
+  values[0] = &d;
+  ffi_call (&cif_neg, FFI_FN(neg), &r, values);
+  CHECK(r == -1.5);
+  CHECK(hooked == 1);
+
+  /* Stopping keeps the counts.  */
+  CHECK(ffi_cif_set_counting (&cif_add, 0) == FFI_OK);
+  values[0] = &a;
+  ffi_call (&cif_add, FFI_FN(add), &res, values);
+  refresh ();
+  CHECK(add_stats.calls == 10);
+  CHECK(neg_stats.calls == 1 && neg_stats.closure_calls == 0);
+
+  /* Preparing again clears them.  */
+  CHECK(ffi_prep_cif(&cif_add, ABI_NUM, 2, &ffi_type_sint, add_args)
+	== FFI_OK);
+  refresh ();
+  CHECK(add_stats.cif == NULL);
+
+  ffi_closure_free (cl);
+  printf ("ok\n");
+  /* { dg-output "ok" } */
+  exit (0);
+}
@@ -0,0 +1,51 @@
+/* Area:	closure trampolines
+   Purpose:	Check that the unwinder finds a frame description for
+		the trampoline of a closure.
+   Limitations:	x86-64 Linux with libgcc's unwinder only.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run { target x86_64-*-linux* } } */
+#include "ffitest.h"
+
+struct dwarf_eh_bases
+{
+  void *tbase;
+  void *dbase;
+  void *func;
+};
+
+extern const void *_Unwind_Find_FDE (void *, struct dwarf_eh_bases *);
+
+static void
+handler (ffi_cif *cif, void *resp, void **args, void *userdata)
+{
+  (void) cif;
+  (void) userdata;
+  *(ffi_arg *) resp = *(int *) args[0] * 2;
+}
+
+int main (void)
+{
+  ffi_cif cif;
+  ffi_type *args[1];
+  ffi_closure *cl;
+  struct dwarf_eh_bases bases;
+  void *code;
+
+  args[0] = &ffi_type_sint;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 1, &ffi_type_sint, args) == FFI_OK);
+  cl = ffi_closure_alloc (sizeof (ffi_closure), &code);
+  CHECK(cl != NULL);
+  CHECK(ffi_prep_closure_loc (cl, &cif, handler, NULL, code) == FFI_OK);
+  CHECK(((int (*)(int)) code) (21) == 42);
+
+  /* As for a return address, look up a pc inside the trampoline.  */
+  CHECK(_Unwind_Find_FDE ((char *) code + 8, &bases) != NULL);
+  CHECK((char *) bases.func <= (char *) code);
+
+  ffi_closure_free (cl);
+  printf ("ok\n");
+  /* { dg-output "ok" } */
+  exit (0);
+}
@@ -0,0 +1,111 @@
+/* Area:	ffi_prep_typed_closure_loc
+   Purpose:	Check that a typed closure calls its target with
+		user_data and the native arguments, and returns the
+		target's result unchanged.
+   Limitations:	Targets without typed closures only check that
+		FFI_BAD_ABI is returned.
+   PR:		none.
+   Originator:	<libffi-discuss@sourceware.org>  */
+
+/* { dg-do run } */
+#include "ffitest.h"
+
+static int counter;
+
+static double
+typed_fn (void *user_data, int i, double d, signed char c, float f,
+	  long long ll)
+{
+  return *(int *) user_data + i + d + c + f + ll;
+}
+
+static unsigned char
+typed_uc (void *user_data, unsigned char c)
+{
+  ++*(int *) user_data;
+  return (unsigned char) (c + 1);
+}
+
+static void
+typed_void (void *user_data)
+{
+  *(int *) user_data += 10;
+}
+
+typedef double (*typed_fn_t) (int, double, signed char, float, long long);
+typedef unsigned char (*typed_uc_t) (unsigned char);
+typedef void (*typed_void_t) (void);
+
+int main (void)
+{
+  ffi_cif cif, cif_uc, cif_void, cif_big;
+  ffi_type *args[MAX_ARGS];
+  ffi_type struct_type, *struct_elements[3];
+  ffi_closure *pcl, *pcl_uc, *pcl_void;
+  void *code, *code_uc, *code_void;
+  int base = 100;
+  ffi_status status;
+  int i;
+
+  pcl = ffi_closure_alloc (sizeof (ffi_closure), &code);
+  pcl_uc = ffi_closure_alloc (sizeof (ffi_closure), &code_uc);
+  pcl_void = ffi_closure_alloc (sizeof (ffi_closure), &code_void);
+  CHECK(pcl != NULL && pcl_uc != NULL && pcl_void != NULL);
+
+  args[0] = &ffi_type_sint;
+  args[1] = &ffi_type_double;
+  args[2] = &ffi_type_schar;
+  args[3] = &ffi_type_float;
+  args[4] = &ffi_type_sint64;
+  CHECK(ffi_prep_cif(&cif, ABI_NUM, 5, &ffi_type_double, args) == FFI_OK);
+
+  status = ffi_prep_typed_closure_loc (pcl, &cif, FFI_FN(typed_fn), &base,
+				       code);
+  if (status == FFI_BAD_ABI)
+    {
+      /* Not supported by this target.  */
+      ffi_closure_free (pcl);
+      ffi_closure_free (pcl_uc);
+      ffi_closure_free (pcl_void);
+      exit (0);
+    }
+  CHECK(status == FFI_OK);
+  CHECK(((typed_fn_t) code) (1, 0.5, -3, 0.25f, 1LL << 40)
+	== 100 + 1 + 0.5 - 3 + 0.25 + (1LL << 40));
+
+  args[0] = &ffi_type_uchar;
+  CHECK(ffi_prep_cif(&cif_uc, ABI_NUM, 1, &ffi_type_uchar, args) == FFI_OK);
+  CHECK(ffi_prep_typed_closure_loc (pcl_uc, &cif_uc, FFI_FN(typed_uc),
+				    &counter, code_uc) == FFI_OK);
+  CHECK(((typed_uc_t) code_uc) (41) == 42);
+  CHECK(counter == 1);
+
+  CHECK(ffi_prep_cif(&cif_void, ABI_NUM, 0, &ffi_type_void, NULL) == FFI_OK);
+  CHECK(ffi_prep_typed_closure_loc (pcl_void, &cif_void, FFI_FN(typed_void),
+				    &counter, code_void) == FFI_OK);
+  ((typed_void_t) code_void) ();
+  CHECK(counter == 11);
+
+  /* Signatures that do not fit in registers with user_data are
+     rejected.  */
+  for (i = 0; i < 6; i++)
+    args[i] = &ffi_type_pointer;
+  CHECK(ffi_prep_cif(&cif_big, ABI_NUM, 6, &ffi_type_void, args) == FFI_OK);
+  CHECK(ffi_prep_typed_closure_loc (pcl, &cif_big, FFI_FN(typed_void),
+				    NULL, code) == FFI_BAD_ABI);
+
+  struct_type.size = struct_type.alignment = 0;
+  struct_type.type = FFI_TYPE_STRUCT;
+  struct_type.elements = struct_elements;
+  struct_elements[0] = struct_elements[1] = &ffi_type_sint;
+  struct_elements[2] = NULL;
+  args[0] = &struct_type;
+  CHECK(ffi_prep_cif(&cif_big, ABI_NUM, 1, &ffi_type_void, args) == FFI_OK);
+  CHECK(ffi_prep_typed_closure_loc (pcl, &cif_big, FFI_FN(typed_void),
+				    NULL, code) == FFI_BAD_ABI);
+
+  ffi_closure_free (pcl);
+  ffi_closure_free (pcl_uc);
+  ffi_closure_free (pcl_void);
+  exit (0);
+}